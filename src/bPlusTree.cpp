@@ -0,0 +1,182 @@
+#include "global.h"
+
+/**
+ * @brief Construct a new BPlusTree object. The tree is empty until bulkLoad is
+ * called. Node pages are stored as "<indexName>_IndexPage<pageIndex>".
+ *
+ * @param indexName
+ */
+BPlusTree::BPlusTree(string indexName)
+{
+    logger.log("BPlusTree::BPlusTree");
+    this->indexName = indexName;
+    //One row of every node page is taken by the header
+    this->maxEntriesPerNode = (uint)((BLOCK_SIZE * 1000) / (sizeof(int) * 3)) - 1;
+}
+
+/**
+ * @brief Writes a node holding the given entries as the next page of the index.
+ *
+ * @param isLeaf
+ * @param entries
+ * @param nextLeafPageIndex
+ * @return int page index of the node
+ */
+int BPlusTree::writeNode(bool isLeaf, vector<vector<int>> &entries, int nextLeafPageIndex)
+{
+    logger.log("BPlusTree::writeNode");
+    vector<vector<int>> rows;
+    rows.reserve(entries.size() + 1);
+    rows.push_back({isLeaf, (int)entries.size(), nextLeafPageIndex});
+    rows.insert(rows.end(), entries.begin(), entries.end());
+    bufferManager.writeIndexPage(this->indexName, this->pageCount, rows, rows.size());
+    return this->pageCount++;
+}
+
+/**
+ * @brief Builds the tree bottom up. First the (value, pageIndex, pagePointer)
+ * entries of the column are written to a temporary table and sorted with the
+ * external sort. The sorted entries are packed into full leaves, then the
+ * first value of every node of a level is packed into the nodes of the level
+ * above until a single root node remains.
+ *
+ * @param table
+ * @param columnIndex
+ */
+void BPlusTree::bulkLoad(Table *table, int columnIndex)
+{
+    logger.log("BPlusTree::bulkLoad");
+    Table *entryTable = new Table(tableCatalogue.getTempTableName(this->indexName + "_Entries"), {"value", "pageIndex", "pagePointer"});
+    tableCatalogue.insertTable(entryTable);
+    PageWriter writer(entryTable);
+    vector<int> entry(3);
+    for (int pageIndex = 0; pageIndex < table->blockCount; pageIndex++)
+    {
+        TablePage page = bufferManager.getPage(table->tableName, pageIndex);
+        for (int pagePointer = 0; pagePointer < page.rowCount; pagePointer++)
+        {
+            entry[0] = page.rows[pagePointer][columnIndex];
+            entry[1] = pageIndex;
+            entry[2] = pagePointer;
+            writer.writeRow(entry);
+        }
+    }
+    writer.close();
+    Table *sortedEntryTable = sortTable(entryTable, tableCatalogue.getTempTableName(this->indexName + "_SortedEntries"), {0, 1, 2}, ASC);
+    tableCatalogue.deleteTable(entryTable->tableName);
+
+    //Leaves are written in order, so the next leaf is always the next page
+    vector<vector<int>> level;
+    vector<vector<int>> entries;
+    entries.reserve(this->maxEntriesPerNode);
+    Cursor cursor = sortedEntryTable->getCursor();
+    long long remainingEntries = sortedEntryTable->rowCount;
+    while (remainingEntries)
+    {
+        entries.clear();
+        while (entries.size() < this->maxEntriesPerNode && remainingEntries)
+        {
+            entries.emplace_back(cursor.getNext());
+            remainingEntries--;
+        }
+        int nextLeafPageIndex = remainingEntries ? this->pageCount + 1 : -1;
+        level.push_back({entries.front()[0], this->writeNode(true, entries, nextLeafPageIndex), 0});
+    }
+    tableCatalogue.deleteTable(sortedEntryTable->tableName);
+    this->height = 1;
+
+    while (level.size() > 1)
+    {
+        vector<vector<int>> upperLevel;
+        for (int entryCounter = 0; entryCounter < level.size(); entryCounter += this->maxEntriesPerNode)
+        {
+            entries.assign(level.begin() + entryCounter, level.begin() + min((int)level.size(), entryCounter + (int)this->maxEntriesPerNode));
+            upperLevel.push_back({entries.front()[0], this->writeNode(false, entries, -1), 0});
+        }
+        level.swap(upperLevel);
+        this->height++;
+    }
+    this->rootPageIndex = level.front()[1];
+}
+
+/**
+ * @brief Descends from the root to the leftmost leaf that can hold value. As a
+ * value may repeat across several leaves, the search follows the last child
+ * whose first value is strictly smaller than value.
+ *
+ * @param value
+ * @return int page index of the leaf
+ */
+int BPlusTree::findLeaf(int value)
+{
+    logger.log("BPlusTree::findLeaf");
+    int pageIndex = this->rootPageIndex;
+    for (int level = 1; level < this->height; level++)
+    {
+        IndexPage *node = bufferManager.getIndexPage(this->indexName, pageIndex);
+        pageIndex = node->rows[1][1];
+        for (int rowCounter = 2; rowCounter < node->rowCount && node->rows[rowCounter][0] < value; rowCounter++)
+            pageIndex = node->rows[rowCounter][1];
+    }
+    return pageIndex;
+}
+
+/**
+ * @brief Returns the locations of the rows whose value in the indexed column
+ * lies in [lowValue, highValue], in order of value.
+ *
+ * @param lowValue
+ * @param highValue
+ * @return vector<pair<int, int>>
+ */
+vector<pair<int, int>> BPlusTree::search(int lowValue, int highValue)
+{
+    logger.log("BPlusTree::search");
+    vector<pair<int, int>> rowLocations;
+    if (this->rootPageIndex < 0 || lowValue > highValue)
+        return rowLocations;
+
+    int pageIndex = this->findLeaf(lowValue);
+    while (pageIndex != -1)
+    {
+        IndexPage *leaf = bufferManager.getIndexPage(this->indexName, pageIndex);
+        for (int rowCounter = 1; rowCounter < leaf->rowCount; rowCounter++)
+        {
+            vector<int> &entry = leaf->rows[rowCounter];
+            if (entry[0] > highValue)
+                return rowLocations;
+            if (entry[0] >= lowValue)
+                rowLocations.emplace_back(entry[1], entry[2]);
+        }
+        pageIndex = leaf->rows[0][2];
+    }
+    return rowLocations;
+}
+
+bool BPlusTree::supportsRangeSearch()
+{
+    return true;
+}
+
+/**
+ * @brief A point search reads one node per level of the tree.
+ *
+ * @return int
+ */
+int BPlusTree::getSearchCost()
+{
+    return this->height;
+}
+
+/**
+ * @brief Deletes all node pages of the tree.
+ *
+ */
+void BPlusTree::unload()
+{
+    logger.log("BPlusTree::unload");
+    for (int pageCounter = 0; pageCounter < this->pageCount; pageCounter++)
+        bufferManager.deleteFile("../data/temp/" + this->indexName + "_IndexPage" + to_string(pageCounter));
+    this->pageCount = 0;
+    this->rootPageIndex = -1;
+}
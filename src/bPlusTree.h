@@ -0,0 +1,41 @@
+#include "pageWriter.h"
+
+/**
+ * @brief The BPlusTree is a disk resident B+ tree index on a column of a table,
+ * created using INDEX ... USING BTREE. Every node is an index page read and
+ * written through the buffer manager. Each node page starts with the header row
+ * (isLeaf, entryCount, nextLeafPageIndex) followed by entryCount entry rows.
+ *
+ * <p>
+ * A leaf entry is (value, pageIndex, pagePointer), the location of a row of
+ * the table holding value. An internal entry is (firstValue, childPageIndex,
+ * 0) where firstValue is the smallest value stored below the child. Leaves are
+ * chained through nextLeafPageIndex (-1 for the last leaf) so range searches
+ * descend once and then walk the leaves.
+ * </p>
+ *
+ * <p>
+ * Since tables cannot be updated, the tree is bulk loaded bottom up from a
+ * sorted scan of the column and every node is filled completely.
+ * </p>
+ *
+ */
+class BPlusTree : public TableIndex
+{
+    string indexName;
+    int rootPageIndex = -1;
+    int height = 0;
+    uint pageCount = 0;
+    uint maxEntriesPerNode = 0;
+
+    int writeNode(bool isLeaf, vector<vector<int>> &entries, int nextLeafPageIndex);
+    int findLeaf(int value);
+
+public:
+    BPlusTree(string indexName);
+    void bulkLoad(Table *table, int columnIndex);
+    vector<pair<int, int>> search(int lowValue, int highValue);
+    bool supportsRangeSearch();
+    int getSearchCost();
+    void unload();
+};
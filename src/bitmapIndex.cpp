@@ -0,0 +1,214 @@
+#include "global.h"
+
+/**
+ * @brief Converts an array container into a bitset container.
+ *
+ * @param container
+ */
+void RoaringBitmap::toBitset(Container &container)
+{
+    container.words.assign(BITSET_WORDS, 0);
+    for (uint16_t value : container.values)
+        container.words[value >> 6] |= 1ull << (value & 63);
+    container.values.clear();
+    container.values.shrink_to_fit();
+}
+
+/**
+ * @brief Sets the bit of id. Adding ids in increasing order, as an index build
+ * does, only ever touches the last container.
+ *
+ * @param id
+ */
+void RoaringBitmap::add(uint id)
+{
+    uint16_t key = id >> 16, value = id & 0xFFFF;
+    auto it = this->containers.end();
+    if (this->containers.empty() || this->containers.back().key != key)
+    {
+        it = lower_bound(this->containers.begin(), this->containers.end(), key, [](const Container &container, uint16_t key) { return container.key < key; });
+        if (it == this->containers.end() || it->key != key)
+        {
+            Container container;
+            container.key = key;
+            it = this->containers.insert(it, container);
+        }
+    }
+    else
+        it--;
+
+    Container &container = *it;
+    if (!container.words.empty())
+    {
+        uint64_t bit = 1ull << (value & 63);
+        if (!(container.words[value >> 6] & bit))
+        {
+            container.words[value >> 6] |= bit;
+            container.cardinality++;
+        }
+        return;
+    }
+    auto position = lower_bound(container.values.begin(), container.values.end(), value);
+    if (position != container.values.end() && *position == value)
+        return;
+    container.values.insert(position, value);
+    container.cardinality++;
+    if (container.cardinality > ARRAY_LIMIT)
+        toBitset(container);
+}
+
+/**
+ * @brief Sets every bit set in other. Containers present in both bitmaps are
+ * merged as sorted arrays if the result stays small and ORed word by word as
+ * bitsets otherwise.
+ *
+ * @param other
+ */
+void RoaringBitmap::unionWith(const RoaringBitmap &other)
+{
+    vector<Container> result;
+    result.reserve(this->containers.size() + other.containers.size());
+    int first = 0, second = 0;
+    while (first < this->containers.size() || second < other.containers.size())
+    {
+        if (second == other.containers.size() || (first < this->containers.size() && this->containers[first].key < other.containers[second].key))
+            result.emplace_back(move(this->containers[first++]));
+        else if (first == this->containers.size() || other.containers[second].key < this->containers[first].key)
+            result.emplace_back(other.containers[second++]);
+        else
+        {
+            Container container = move(this->containers[first++]);
+            const Container &otherContainer = other.containers[second++];
+            if (container.words.empty() && otherContainer.words.empty() && container.cardinality + otherContainer.cardinality <= ARRAY_LIMIT)
+            {
+                vector<uint16_t> values;
+                values.reserve(container.cardinality + otherContainer.cardinality);
+                set_union(container.values.begin(), container.values.end(), otherContainer.values.begin(), otherContainer.values.end(), back_inserter(values));
+                container.values.swap(values);
+                container.cardinality = container.values.size();
+            }
+            else
+            {
+                if (container.words.empty())
+                    toBitset(container);
+                if (otherContainer.words.empty())
+                    for (uint16_t value : otherContainer.values)
+                        container.words[value >> 6] |= 1ull << (value & 63);
+                else
+                    for (int word = 0; word < BITSET_WORDS; word++)
+                        container.words[word] |= otherContainer.words[word];
+                container.cardinality = 0;
+                for (uint64_t word : container.words)
+                    container.cardinality += __builtin_popcountll(word);
+            }
+            result.emplace_back(move(container));
+        }
+    }
+    this->containers.swap(result);
+}
+
+/**
+ * @brief Number of ids set in the bitmap.
+ *
+ * @return long long
+ */
+long long RoaringBitmap::getCardinality()
+{
+    long long cardinality = 0;
+    for (auto &container : this->containers)
+        cardinality += container.cardinality;
+    return cardinality;
+}
+
+/**
+ * @brief Returns the ids set in the bitmap in increasing order.
+ *
+ * @return vector<uint>
+ */
+vector<uint> RoaringBitmap::getIds()
+{
+    vector<uint> ids;
+    ids.reserve(this->getCardinality());
+    for (auto &container : this->containers)
+    {
+        uint high = (uint)container.key << 16;
+        if (container.words.empty())
+        {
+            for (uint16_t value : container.values)
+                ids.push_back(high | value);
+            continue;
+        }
+        for (int word = 0; word < BITSET_WORDS; word++)
+        {
+            uint64_t bits = container.words[word];
+            while (bits)
+            {
+                ids.push_back(high | (word << 6 | __builtin_ctzll(bits)));
+                bits &= bits - 1;
+            }
+        }
+    }
+    return ids;
+}
+
+/**
+ * @brief Builds one bitmap per distinct value of the column in a single scan.
+ * The id of a row is pageIndex * maxRowsPerBlock + pagePointer.
+ *
+ * @param table
+ * @param columnIndex
+ */
+void BitmapIndex::build(Table *table, int columnIndex)
+{
+    logger.log("BitmapIndex::build");
+    this->maxRowsPerBlock = table->maxRowsPerBlock;
+    for (int pageIndex = 0; pageIndex < table->blockCount; pageIndex++)
+    {
+        TablePage page = bufferManager.getPage(table->tableName, pageIndex);
+        for (int pagePointer = 0; pagePointer < page.rowCount; pagePointer++)
+            this->bitmaps[page.rows[pagePointer][columnIndex]].add((uint)pageIndex * this->maxRowsPerBlock + pagePointer);
+    }
+}
+
+/**
+ * @brief ORs the bitmaps of all values in [lowValue, highValue] and returns the
+ * locations of the rows set in the result, in row order.
+ *
+ * @param lowValue
+ * @param highValue
+ * @return vector<pair<int, int>>
+ */
+vector<pair<int, int>> BitmapIndex::search(int lowValue, int highValue)
+{
+    logger.log("BitmapIndex::search");
+    RoaringBitmap result;
+    if (lowValue <= highValue)
+        for (auto it = this->bitmaps.lower_bound(lowValue); it != this->bitmaps.end() && it->first <= highValue; it++)
+            result.unionWith(it->second);
+
+    vector<pair<int, int>> rowLocations;
+    for (uint id : result.getIds())
+        rowLocations.emplace_back(id / this->maxRowsPerBlock, id % this->maxRowsPerBlock);
+    return rowLocations;
+}
+
+bool BitmapIndex::supportsRangeSearch()
+{
+    return true;
+}
+
+/**
+ * @brief The bitmaps are held in memory, a search reads no index pages.
+ *
+ * @return int
+ */
+int BitmapIndex::getSearchCost()
+{
+    return 0;
+}
+
+void BitmapIndex::unload()
+{
+    logger.log("BitmapIndex::unload");
+    this->bitmaps.clear();
+}
@@ -0,0 +1,53 @@
+#include "hashIndex.h"
+
+/**
+ * @brief Compressed bitmap over 32 bit row ids in the style of Roaring
+ * bitmaps. Ids are split into a 16 bit key and a 16 bit low part; the low
+ * parts sharing a key are kept in a container that is a sorted array while it
+ * holds at most ARRAY_LIMIT values and a plain 2^16 bit bitset otherwise.
+ *
+ */
+class RoaringBitmap
+{
+    static const int ARRAY_LIMIT = 4096;
+    static const int BITSET_WORDS = 1024;
+
+    struct Container
+    {
+        uint16_t key;
+        int cardinality = 0;
+        vector<uint16_t> values;
+        vector<uint64_t> words;
+    };
+    vector<Container> containers;
+
+    static void toBitset(Container &container);
+
+public:
+    void add(uint id);
+    void unionWith(const RoaringBitmap &other);
+    long long getCardinality();
+    vector<uint> getIds();
+};
+
+/**
+ * @brief The BitmapIndex keeps one compressed bitmap of row ids per distinct
+ * value of a column, created using INDEX ... USING BITMAP. It is meant for
+ * columns with few distinct values, for which the bitmaps are small enough to
+ * be kept in memory. A search ORs the bitmaps of all values in the searched
+ * range and returns the locations of the rows set in the result, so only pages
+ * holding matching rows are read.
+ *
+ */
+class BitmapIndex : public TableIndex
+{
+    map<int, RoaringBitmap> bitmaps;
+    uint maxRowsPerBlock = 0;
+
+public:
+    void build(Table *table, int columnIndex);
+    vector<pair<int, int>> search(int lowValue, int highValue);
+    bool supportsRangeSearch();
+    int getSearchCost();
+    void unload();
+};
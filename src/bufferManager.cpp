@@ -17,10 +17,18 @@ TablePage BufferManager::getPage(string tableName, int pageIndex)
 {
     logger.log("BufferManager::getPage");
     string pageName = "../data/temp/" + tableName + "_Page" + to_string(pageIndex);
-    if (this->inPool(pageName))
-        return *this->getFromPool(pageName);
-    else
-        return *this->insertIntoPool(tableName, pageIndex);
+    {
+        lock_guard<mutex> lock(this->poolMutex);
+        if (this->inPool(pageName))
+        {
+            this->bufferHitCount++;
+            return *this->getFromPool(pageName);
+        }
+    }
+    TablePage *page = new TablePage(tableName, pageIndex);
+    lock_guard<mutex> lock(this->poolMutex);
+    this->pageReadCount++;
+    return *this->insertIntoPool(page);
 }
 
 /**
@@ -36,10 +44,54 @@ MatrixPage *BufferManager::getMatrixPage(string matrixName, int pageIndex)
     logger.log("BufferManager::getMatrixPage");
     string pageName = "../data/temp/" + matrixName + "_Page" + to_string(pageIndex);
     // cout << matrixName << " " << pageIndex << " reached buffer manager get matrix page" << endl;
+    lock_guard<mutex> lock(this->poolMutex);
     if (this->inPool(pageName))
+    {
+        this->bufferHitCount++;
         return this->getMatrixFromPool(pageName);
-    else
-        return this->insertMatrixIntoPool(matrixName, pageIndex);
+    }
+    this->pageReadCount++;
+    return this->insertMatrixIntoPool(matrixName, pageIndex);
+}
+
+/**
+ * @brief Reads a matrix page from disk into a page owned by the caller,
+ * without going through the pool. Used by threads that modify matrix pages
+ * concurrently; they write them back with writeMatrixPage, which drops any
+ * copy of the page left in the pool.
+ *
+ * @param matrixName
+ * @param pageIndex
+ * @return MatrixPage
+ */
+MatrixPage BufferManager::readMatrixPage(string matrixName, int pageIndex)
+{
+    logger.log("BufferManager::readMatrixPage");
+    this->pageReadCount++;
+    return MatrixPage(matrixName, pageIndex);
+}
+
+/**
+ * @brief Function called to read an index page from the buffer manager. If the
+ * page is not present in the pool, the page is read and then inserted into the
+ * pool.
+ *
+ * @param indexName
+ * @param pageIndex
+ * @return IndexPage*
+ */
+IndexPage *BufferManager::getIndexPage(string indexName, int pageIndex)
+{
+    logger.log("BufferManager::getIndexPage");
+    string pageName = "../data/temp/" + indexName + "_IndexPage" + to_string(pageIndex);
+    lock_guard<mutex> lock(this->poolMutex);
+    if (this->inPool(pageName))
+    {
+        this->bufferHitCount++;
+        return this->getIndexFromPool(pageName);
+    }
+    this->pageReadCount++;
+    return this->insertIndexIntoPool(indexName, pageIndex);
 }
 
 /**
@@ -95,18 +147,33 @@ MatrixPage *BufferManager::getMatrixFromPool(string pageName)
 }
 
 /**
- * @brief Inserts page indicated by tableName and pageIndex into pool. If the
- * pool is full, the pool ejects the oldest inserted page from the pool and adds
- * the current page at the end. It naturally follows a queue data structure.
+ * @brief If the page is present in the pool, then this function returns the
+ * page. Note that this function will fail if the page is not present in the
+ * pool or page type is not index.
  *
- * @param tableName
- * @param pageIndex
+ * @param pageName
+ * @return IndexPage*
+ */
+IndexPage *BufferManager::getIndexFromPool(string pageName)
+{
+    logger.log("BufferManager::getIndexFromPool");
+    for (auto page : this->pages)
+        if (pageName == page->pageName)
+            return dynamic_cast<IndexPage *>(page);
+    return NULL;
+}
+
+/**
+ * @brief Inserts a page read from disk into pool. If the pool is full, the
+ * pool ejects the oldest inserted page from the pool and adds the current page
+ * at the end. It naturally follows a queue data structure.
+ *
+ * @param page
  * @return TablePage*
  */
-TablePage *BufferManager::insertIntoPool(string tableName, int pageIndex)
+TablePage *BufferManager::insertIntoPool(TablePage *page)
 {
     logger.log("BufferManager::insertIntoPool");
-    TablePage *page = new TablePage(tableName, pageIndex);
     if (this->pages.size() >= BLOCK_COUNT)
     {
         delete pages.front();
@@ -138,6 +205,51 @@ MatrixPage *BufferManager::insertMatrixIntoPool(string matrixName, int pageIndex
     return page;
 }
 
+/**
+ * @brief Inserts page indicated by indexName and pageIndex into pool. If the
+ * pool is full, the pool ejects the oldest inserted page from the pool and adds
+ * the current page at the end. It naturally follows a queue data structure.
+ *
+ * @param indexName
+ * @param pageIndex
+ * @return IndexPage*
+ */
+IndexPage *BufferManager::insertIndexIntoPool(string indexName, int pageIndex)
+{
+    logger.log("BufferManager::insertIndexIntoPool");
+    IndexPage *page = new IndexPage(indexName, pageIndex);
+    if (this->pages.size() >= BLOCK_COUNT)
+    {
+        delete pages.front();
+        pages.pop_front();
+    }
+    pages.push_back(page);
+    return page;
+}
+
+/**
+ * @brief Drops the page indicated by pageName from the pool if it is present.
+ * Called whenever the page on disk is overwritten or deleted so that a stale
+ * copy is never handed out, e.g. when a temporary table is cleared and a new
+ * table with the same name is created later.
+ *
+ * @param pageName
+ */
+void BufferManager::removeFromPool(string pageName)
+{
+    logger.log("BufferManager::removeFromPool");
+    lock_guard<mutex> lock(this->poolMutex);
+    for (auto it = this->pages.begin(); it != this->pages.end(); it++)
+    {
+        if ((*it)->pageName == pageName)
+        {
+            delete *it;
+            this->pages.erase(it);
+            return;
+        }
+    }
+}
+
 /**
  * @brief The buffer manager is also responsible for writing pages. This is
  * called when new tables are created using assignment statements or load.
@@ -151,12 +263,15 @@ void BufferManager::writePage(string tableName, int pageIndex, vector<vector<int
 {
     logger.log("BufferManager::writePage");
     TablePage page(tableName, pageIndex, rows, rowCount);
+    this->removeFromPool(page.pageName);
     page.writePage();
+    this->pageWriteCount++;
 }
 
 /**
  * @brief The buffer manager is also responsible for writing pages. This is
- * called when new matrices are created using load.
+ * called when new matrices are created using load. The page is written in the
+ * encoding that suits its values, which the caller records in the matrix.
  *
  * @param tableName
  * @param pageIndex
@@ -164,12 +279,34 @@ void BufferManager::writePage(string tableName, int pageIndex, vector<vector<int
  * @param rowCount
  * @param colStartIdx
  * @param columnCount
+ * @return TileEncoding
  */
-void BufferManager::writeMatrixPage(string matrixName, int pageIndex, vector<vector<int>> rows, int rowCount)
+TileEncoding BufferManager::writeMatrixPage(string matrixName, int pageIndex, vector<vector<int>> rows, int rowCount)
 {
     logger.log("BufferManager::writeMatrixPage");
     MatrixPage page(matrixName, pageIndex, rows, rowCount);
+    this->removeFromPool(page.pageName);
     page.writePage();
+    this->pageWriteCount++;
+    return page.encoding;
+}
+
+/**
+ * @brief The buffer manager is also responsible for writing pages. This is
+ * called when index nodes are created or modified.
+ *
+ * @param indexName
+ * @param pageIndex
+ * @param rows
+ * @param rowCount
+ */
+void BufferManager::writeIndexPage(string indexName, int pageIndex, vector<vector<int>> rows, int rowCount)
+{
+    logger.log("BufferManager::writeIndexPage");
+    IndexPage page(indexName, pageIndex, rows, rowCount);
+    this->removeFromPool(page.pageName);
+    page.writePage();
+    this->pageWriteCount++;
 }
 
 // void BufferManager::writeMatrixPage(string matrixName, int pageIndex, vector<vector<int>> rows, int rowCount, int colCount)
@@ -180,12 +317,14 @@ void BufferManager::writeMatrixPage(string matrixName, int pageIndex, vector<vec
 // }
 
 /**
- * @brief Deletes file names fileName
+ * @brief Deletes file names fileName, dropping its page from the pool if it is
+ * one
  *
  * @param fileName
  */
 void BufferManager::deleteFile(string fileName)
 {
+    this->removeFromPool(fileName);
 
     if (remove(fileName.c_str()))
         logger.log("BufferManager::deleteFile: Err");
@@ -193,6 +332,27 @@ void BufferManager::deleteFile(string fileName)
         logger.log("BufferManager::deleteFile: Success");
 }
 
+/**
+ * @brief Exchanges the files of two pages of a matrix, either of which may
+ * have none, and drops both pages from the pool. Nothing is read or written.
+ *
+ * @param matrixName
+ * @param firstPageIndex
+ * @param secondPageIndex
+ */
+void BufferManager::swapMatrixPages(string matrixName, int firstPageIndex, int secondPageIndex)
+{
+    logger.log("BufferManager::swapMatrixPages");
+    string firstPageName = "../data/temp/" + matrixName + "_Page" + to_string(firstPageIndex);
+    string secondPageName = "../data/temp/" + matrixName + "_Page" + to_string(secondPageIndex);
+    string swapPageName = firstPageName + "_Swap";
+    this->removeFromPool(firstPageName);
+    this->removeFromPool(secondPageName);
+    rename(firstPageName.c_str(), swapPageName.c_str());
+    rename(secondPageName.c_str(), firstPageName.c_str());
+    rename(swapPageName.c_str(), secondPageName.c_str());
+}
+
 /**
  * @brief Overloaded function that calls deleteFile(fileName) by constructing
  * the fileName from the relationName and pageIndex.
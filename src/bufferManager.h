@@ -22,26 +22,50 @@
  * was previously present in the buffer or was read in from the disk.
  * </p>
  *
+ * <p>
+ * Table pages may be requested by several threads at once (the workers of a
+ * parallel scan): the pool is guarded by a mutex and getPage hands out copies.
+ * Pages missing from the pool are read outside the lock so that workers read
+ * and parse their pages concurrently. Matrix and index pages are returned as
+ * pointers into the pool and are only to be used from a single thread;
+ * threads working on matrix pages concurrently read copies of their own with
+ * readMatrixPage.
+ * </p>
+ *
  */
 class BufferManager
 {
 
     deque<Page *> pages;
+    mutex poolMutex;
     bool inPool(string pageName);
     TablePage *getFromPool(string pageName);
     MatrixPage *getMatrixFromPool(string pageName);
-    TablePage *insertIntoPool(string tableName, int pageIndex);
+    TablePage *insertIntoPool(TablePage *page);
     MatrixPage *insertMatrixIntoPool(string matrixName, int pageIndex);
+    IndexPage *getIndexFromPool(string pageName);
+    IndexPage *insertIndexIntoPool(string indexName, int pageIndex);
+    void removeFromPool(string pageName);
 
 public:
+    //Page accesses since startup, for EXPLAIN ANALYZE. A page found in the
+    //pool is a buffer hit, any other is read from disk.
+    atomic<long long> pageReadCount{0};
+    atomic<long long> bufferHitCount{0};
+    atomic<long long> pageWriteCount{0};
+
     BufferManager();
     ~BufferManager();
     TablePage getPage(string tableName, int pageIndex);
     MatrixPage *getMatrixPage(string matrixName, int pageIndex);
+    MatrixPage readMatrixPage(string matrixName, int pageIndex);
+    IndexPage *getIndexPage(string indexName, int pageIndex);
     void deleteFile(string relationName, int pageIndex);
     void deleteFile(string fileName);
     void writePage(string tableName, int pageIndex, vector<vector<int>> rows, int rowCount);
-    void writeMatrixPage(string matrixName, int pageIndex, vector<vector<int>> rows, int rowCount);
+    TileEncoding writeMatrixPage(string matrixName, int pageIndex, vector<vector<int>> rows, int rowCount);
+    void writeIndexPage(string indexName, int pageIndex, vector<vector<int>> rows, int rowCount);
+    void swapMatrixPages(string matrixName, int firstPageIndex, int secondPageIndex);
     // void writeMatrixPage(string matrixName, int pageIndex, vector<vector<int>> rows, int rowCount, int colCount); // this is for sparse matrix storage, colCount = 3
 };
 
@@ -1,12 +1,25 @@
 #include "global.h"
 
-Cursor::Cursor(string tableName, int pageIndex)
+atomic<long long> Cursor::rowReadCount(0);
+
+/**
+ * @brief Construct a new Cursor on page pageIndex of the table. A cursor given
+ * an endPageIndex only reads the pages before it through getNextBatch, which
+ * is how the workers of a parallel scan read their morsels.
+ *
+ * @param tableName
+ * @param pageIndex
+ * @param endPageIndex
+ */
+Cursor::Cursor(string tableName, int pageIndex, int endPageIndex)
 {
     logger.log("Cursor::Cursor");
     this->page = bufferManager.getPage(tableName, pageIndex);
     this->pagePointer = 0;
     this->tableName = tableName;
     this->pageIndex = pageIndex;
+    this->endPageIndex = endPageIndex;
+    this->table = tableCatalogue.getTable(tableName);
 }
 
 /**
@@ -22,14 +35,41 @@ vector<int> Cursor::getNext()
     vector<int> result = this->page.getRow(this->pagePointer);
     this->pagePointer++;
     if(result.empty()){
-        tableCatalogue.getTable(this->tableName)->getNextPage(this);
+        this->table->getNextPage(this);
         if(!this->pagePointer){
             result = this->page.getRow(this->pagePointer);
             this->pagePointer++;
         }
     }
+    rowReadCount += !result.empty();
     return result;
 }
+
+/**
+ * @brief Returns a view of up to maxRowCount rows starting at the pagePointer,
+ * moving on to the next page when the current one has been read completely.
+ * Rows are neither copied nor logged individually, which is what operators
+ * scanning whole tables should use. An empty batch marks the end of the
+ * table.
+ *
+ * @param maxRowCount 
+ * @return RowBatch 
+ */
+RowBatch Cursor::getNextBatch(int maxRowCount)
+{
+    RowBatch batch;
+    int endPageIndex = this->endPageIndex < 0 ? this->table->blockCount : this->endPageIndex;
+    while(this->pagePointer >= this->page.rowCount){
+        if(this->pageIndex >= endPageIndex - 1)
+            return batch;
+        this->nextPage(this->pageIndex + 1);
+    }
+    batch.rows = this->page.rows.data() + this->pagePointer;
+    batch.rowCount = min(maxRowCount, this->page.rowCount - this->pagePointer);
+    this->pagePointer += batch.rowCount;
+    rowReadCount += batch.rowCount;
+    return batch;
+}
 /**
  * @brief Function that loads Page indicated by pageIndex. Now the cursor starts
  * reading from the new page.
@@ -1,8 +1,28 @@
 #include"bufferManager.h"
+
+class Table;
+
+/**
+ * @brief A batch of consecutive rows of the page a cursor is on. The batch is
+ * a view into the cursor's copy of the page, no rows are copied, so it stays
+ * valid only until the cursor moves on to the next page.
+ *
+ */
+class RowBatch{
+    public:
+    const vector<int> *rows = NULL;
+    int rowCount = 0;
+
+    const vector<int> &operator[](int rowIndex) const { return this->rows[rowIndex]; }
+    const vector<int> *begin() const { return this->rows; }
+    const vector<int> *end() const { return this->rows + this->rowCount; }
+    bool empty() const { return this->rowCount == 0; }
+};
+
 /**
  * @brief The cursor is an important component of the system. To read from a
  * table, you need to initialize a cursor. The cursor reads rows from a page one
- * at a time.
+ * at a time, or a batch of rows at a time using getNextBatch.
  *
  */
 class Cursor{
@@ -11,9 +31,15 @@ class Cursor{
     int pageIndex;
     string tableName;
     int pagePointer;
+    //Batches stop before this page, -1 reads up to the end of the table
+    int endPageIndex = -1;
+    Table *table = NULL;
+    //Rows read through any cursor since startup, for EXPLAIN ANALYZE
+    static atomic<long long> rowReadCount;
 
     public:
-    Cursor(string tableName, int pageIndex);
+    Cursor(string tableName, int pageIndex, int endPageIndex = -1);
     vector<int> getNext();
+    RowBatch getNextBatch(int maxRowCount = INT_MAX);
     void nextPage(int pageIndex);
 };
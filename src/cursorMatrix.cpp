@@ -46,17 +46,7 @@ vector<int> CursorMatrix::getNext()
     logger.log("CursorMatrix::getNext");
 
     vector<int> result = this->page.getRow(this->pagePointer);
-
-    if (matrixCatalogue.getMatrix(this->matrixName)->isSparseMatrix)
-    {
-        return this->getNextPageRow();
-    }
-
-    else
-    {
-        matrixCatalogue.getMatrix(this->matrixName)->getNextPointer(this);
-    }
-
+    matrixCatalogue.getMatrix(this->matrixName)->getNextPointer(this);
     return result;
 }
 
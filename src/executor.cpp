@@ -6,8 +6,10 @@ void executeCommand(){
         case CLEAR: executeCLEAR(); break;
         case CROSS: executeCROSS(); break;
         case DISTINCT: executeDISTINCT(); break;
+        case EXPLAIN: executeEXPLAIN(); break;
         case EXPORT: executeEXPORT(); break;
         case EXPORTMATRIX: executeEXPORTMATRIX(); break;
+        case GROUPBY: executeGROUPBY(); break;
         case INDEX: executeINDEX(); break;
         case JOIN: executeJOIN(); break;
         case LIST: executeLIST(); break;
@@ -16,6 +18,7 @@ void executeCommand(){
         case TRANSPOSE: executeTRANSPOSE(); break;
         case PRINT: executePRINT(); break;
         case PRINTMATRIX: executePRINTMATRIX(); break;
+        case PIPELINE: executePIPELINE(); break;
         case PROJECTION: executePROJECTION(); break;
         case RENAME: executeRENAME(); break;
         case SELECTION: executeSELECTION(); break;
@@ -1,12 +1,14 @@
-#include"semanticParser.h"
+#include"parallel.h"
 
 void executeCommand();
 
 void executeCLEAR();
 void executeCROSS();
 void executeDISTINCT();
+void executeEXPLAIN();
 void executeEXPORT();
 void executeEXPORTMATRIX();
+void executeGROUPBY();
 void executeINDEX();
 void executeJOIN();
 void executeLIST();
@@ -15,11 +17,22 @@ void executeLOADMATRIX();
 void executeTRANSPOSE();
 void executePRINT();
 void executePRINTMATRIX();
+void executePIPELINE();
 void executePROJECTION();
 void executeRENAME();
 void executeSELECTION();
 void executeSORT();
 void executeSOURCE();
 
+string getAggregateFunctionName(AggregateFunction aggregateFunction);
 bool evaluateBinOp(int value1, int value2, BinaryOperator binaryOperator);
+int findIndexedCondition(Table *table, const vector<vector<BoundCondition>> &conjunctions, int &lowValue, int &highValue);
+unique_ptr<Operator> buildOperator(PlanNode *node);
+vector<string> getJoinColumns(string firstRelationName, const vector<string> &firstColumns, string secondRelationName, const vector<string> &secondColumns);
+vector<string> getJoinColumns(Table *table1, Table *table2);
+void writeJoinedRow(const vector<int> &row, const vector<int> &otherRow, bool rowIsFirst, vector<int> &resultantRow, PageWriter &writer);
+void joinTables(Table *table1, int firstColumnIndex, Table *table2, int secondColumnIndex, BinaryOperator binaryOperator, PageWriter &writer);
+void blockNestedLoopJoin(Table *table1, int firstColumnIndex, Table *table2, int secondColumnIndex, BinaryOperator binaryOperator, PageWriter &writer);
+vector<Table *> partitionTable(Table *table, vector<int> columnIndices, int partitionCount, int seed);
+Table* sortTable(Table* table, string resultRelationName, vector<int> columnIndices, SortingStrategy sortingStrategy, int limit = -1);
 void printRowCount(int rowCount);
\ No newline at end of file
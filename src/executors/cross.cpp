@@ -37,67 +37,144 @@ bool semanticParseCROSS()
     return true;
 }
 
-void executeCROSS()
+/**
+ * @brief Builds the column list of a cross product or join result. Columns of
+ * the second relation follow those of the first. If there are columns with the
+ * same names in the two relations, the columns are indexed with the relation
+ * name. If both relations are the same, relation names are indexed with '1'
+ * and '2'.
+ *
+ * @param firstRelationName
+ * @param firstColumns
+ * @param secondRelationName
+ * @param secondColumns
+ * @return vector<string>
+ */
+vector<string> getJoinColumns(string firstRelationName, const vector<string> &firstColumns, string secondRelationName, const vector<string> &secondColumns)
 {
-    logger.log("executeCROSS");
-
-    Table table1 = *(tableCatalogue.getTable(parsedQuery.crossFirstRelationName));
-    Table table2 = *(tableCatalogue.getTable(parsedQuery.crossSecondRelationName));
-
-    vector<string> columns;
-
-    //If both tables are the same i.e. CROSS a a, then names are indexed as a1 and a2
-    if(table1.tableName == table2.tableName){
-        parsedQuery.crossFirstRelationName += "1";
-        parsedQuery.crossSecondRelationName += "2";
+    if (firstRelationName == secondRelationName)
+    {
+        firstRelationName += "1";
+        secondRelationName += "2";
     }
 
-    //Creating list of column names
-    for (int columnCounter = 0; columnCounter < table1.columnCount; columnCounter++)
+    vector<string> columns;
+    for (auto columnName : firstColumns)
     {
-        string columnName = table1.columns[columnCounter];
-        if (table2.isColumn(columnName))
-        {
-            columnName = parsedQuery.crossFirstRelationName + "_" + columnName;
-        }
+        if (find(secondColumns.begin(), secondColumns.end(), columnName) != secondColumns.end())
+            columnName = firstRelationName + "_" + columnName;
         columns.emplace_back(columnName);
     }
-
-    for (int columnCounter = 0; columnCounter < table2.columnCount; columnCounter++)
+    for (auto columnName : secondColumns)
     {
-        string columnName = table2.columns[columnCounter];
-        if (table1.isColumn(columnName))
-        {
-            columnName = parsedQuery.crossSecondRelationName + "_" + columnName;
-        }
+        if (find(firstColumns.begin(), firstColumns.end(), columnName) != firstColumns.end())
+            columnName = secondRelationName + "_" + columnName;
         columns.emplace_back(columnName);
     }
+    return columns;
+}
 
-    Table *resultantTable = new Table(parsedQuery.crossResultRelationName, columns);\
+vector<string> getJoinColumns(Table *table1, Table *table2)
+{
+    return getJoinColumns(table1->tableName, table1->columns, table2->tableName, table2->columns);
+}
 
-    Cursor cursor1 = table1.getCursor();
-    Cursor cursor2 = table2.getCursor();
+/**
+ * @brief Writes the concatenation of row and otherRow, the row belonging to the
+ * first relation of the cross product or join always comes first.
+ *
+ * @param row
+ * @param otherRow
+ * @param rowIsFirst true if row belongs to the first relation
+ * @param resultantRow buffer reused across calls
+ * @param writer
+ */
+void writeJoinedRow(const vector<int> &row, const vector<int> &otherRow, bool rowIsFirst, vector<int> &resultantRow, PageWriter &writer)
+{
+    const vector<int> &firstRow = rowIsFirst ? row : otherRow;
+    const vector<int> &secondRow = rowIsFirst ? otherRow : row;
+    resultantRow.assign(firstRow.begin(), firstRow.end());
+    resultantRow.insert(resultantRow.end(), secondRow.begin(), secondRow.end());
+    writer.writeRow(resultantRow);
+}
 
-    vector<int> row1 = cursor1.getNext();
-    vector<int> row2;
-    vector<int> resultantRow;
-    resultantRow.reserve(resultantTable->columnCount);
+/**
+ * @brief Block nested loop join. The relation with fewer blocks is the outer
+ * relation, it is read MEMORY_BLOCK_COUNT - 2 blocks at a time (leaving a block
+ * each for the inner and the output page) and the inner relation is scanned
+ * once per chunk instead of once per outer row. With binaryOperator set to
+ * NO_BINOP_CLAUSE every pair of rows is written, i.e. the cross product.
+ *
+ * @param table1
+ * @param firstColumnIndex join column of table1, ignored for cross products
+ * @param table2
+ * @param secondColumnIndex join column of table2, ignored for cross products
+ * @param binaryOperator
+ * @param writer
+ */
+void blockNestedLoopJoin(Table *table1, int firstColumnIndex, Table *table2, int secondColumnIndex, BinaryOperator binaryOperator, PageWriter &writer)
+{
+    logger.log("blockNestedLoopJoin");
+    bool outerIsFirst = table1->blockCount <= table2->blockCount;
+    Table *outerTable = outerIsFirst ? table1 : table2;
+    Table *innerTable = outerIsFirst ? table2 : table1;
+    int outerColumnIndex = outerIsFirst ? firstColumnIndex : secondColumnIndex;
+    int innerColumnIndex = outerIsFirst ? secondColumnIndex : firstColumnIndex;
+    int chunkBlockCount = max((int)MEMORY_BLOCK_COUNT - 2, 1);
 
-    while (!row1.empty())
+    //The outer join column is compared against one inner value at a time
+    PredicateKernel kernel = getPredicateKernel(outerIsFirst ? binaryOperator : mirrorBinaryOperator(binaryOperator), true);
+    vector<vector<int>> outerRows;
+    outerRows.reserve((long long)chunkBlockCount * outerTable->maxRowsPerBlock);
+    vector<int> outerValues, selection;
+    vector<int> resultantRow;
+    resultantRow.reserve(table1->columnCount + table2->columnCount);
+    for (int chunkStart = 0; chunkStart < outerTable->blockCount; chunkStart += chunkBlockCount)
     {
+        outerRows.clear();
+        for (int pageIndex = chunkStart; pageIndex < min(chunkStart + chunkBlockCount, (int)outerTable->blockCount); pageIndex++)
+        {
+            TablePage page = bufferManager.getPage(outerTable->tableName, pageIndex);
+            outerRows.insert(outerRows.end(), page.rows.begin(), page.rows.begin() + page.rowCount);
+        }
+        if (binaryOperator != NO_BINOP_CLAUSE)
+        {
+            outerValues.resize(outerRows.size());
+            selection.resize(outerRows.size());
+            for (int rowCounter = 0; rowCounter < outerRows.size(); rowCounter++)
+                outerValues[rowCounter] = outerRows[rowCounter][outerColumnIndex];
+        }
 
-        cursor2 = table2.getCursor();
-        row2 = cursor2.getNext();
-        while (!row2.empty())
+        Cursor cursor = innerTable->getCursor();
+        for (RowBatch batch = cursor.getNextBatch(); !batch.empty(); batch = cursor.getNextBatch())
         {
-            resultantRow = row1;
-            resultantRow.insert(resultantRow.end(), row2.begin(), row2.end());
-            resultantTable->writeRow<int>(resultantRow);
-            row2 = cursor2.getNext();
+            for (auto &innerRow : batch)
+            {
+                if (binaryOperator == NO_BINOP_CLAUSE)
+                {
+                    for (auto &outerRow : outerRows)
+                        writeJoinedRow(outerRow, innerRow, outerIsFirst, resultantRow, writer);
+                    continue;
+                }
+                int selectedCount = kernel(outerValues.data(), NULL, innerRow[innerColumnIndex], outerValues.size(), selection.data());
+                for (int selectedCounter = 0; selectedCounter < selectedCount; selectedCounter++)
+                    writeJoinedRow(outerRows[selection[selectedCounter]], innerRow, outerIsFirst, resultantRow, writer);
+            }
         }
-        row1 = cursor1.getNext();
     }
-    resultantTable->blockify();
+}
+
+void executeCROSS()
+{
+    logger.log("executeCROSS");
+
+    Table *table1 = tableCatalogue.getTable(parsedQuery.crossFirstRelationName);
+    Table *table2 = tableCatalogue.getTable(parsedQuery.crossSecondRelationName);
+
+    Table *resultantTable = new Table(parsedQuery.crossResultRelationName, getJoinColumns(table1, table2));
+    PageWriter writer(resultantTable);
+    blockNestedLoopJoin(table1, -1, table2, -1, NO_BINOP_CLAUSE, writer);
+    writer.close();
     tableCatalogue.insertTable(resultantTable);
     return;
-}
\ No newline at end of file
+}
@@ -36,8 +36,223 @@ bool semanticParseDISTINCT()
     return true;
 }
 
+/**
+ * @brief Open addressing (linear probing) hash set over full rows. Rows are
+ * stored back to back in one array and the slot table only holds row numbers,
+ * so inserting a row never allocates except when the set grows.
+ */
+class RowHashSet
+{
+    int columnCount;
+    long long rowCount = 0;
+    vector<int> values;
+    //Row number + 1 of the row stored in a slot, 0 marks an empty slot
+    vector<long long> slots;
+    unsigned long long mask;
+
+    unsigned long long hashRow(const int *row)
+    {
+        unsigned long long hash = 0xCBF29CE484222325ull;
+        for (int columnCounter = 0; columnCounter < this->columnCount; columnCounter++)
+        {
+            hash = (hash ^ (uint)row[columnCounter]) * 0x100000001B3ull;
+            hash ^= hash >> 29;
+        }
+        return hash;
+    }
+
+    long long findSlot(const int *row)
+    {
+        unsigned long long slot = this->hashRow(row) & this->mask;
+        while (this->slots[slot])
+        {
+            const int *storedRow = &this->values[(this->slots[slot] - 1) * this->columnCount];
+            if (equal(storedRow, storedRow + this->columnCount, row))
+                break;
+            slot = (slot + 1) & this->mask;
+        }
+        return slot;
+    }
+
+    void grow()
+    {
+        vector<long long> oldSlots;
+        oldSlots.swap(this->slots);
+        this->slots.assign(oldSlots.size() * 2, 0);
+        this->mask = this->slots.size() - 1;
+        for (long long rowNumber : oldSlots)
+            if (rowNumber)
+                this->slots[this->findSlot(&this->values[(rowNumber - 1) * this->columnCount])] = rowNumber;
+    }
+
+public:
+    RowHashSet(int columnCount, long long expectedRowCount)
+    {
+        this->columnCount = columnCount;
+        unsigned long long capacity = 16;
+        while (capacity < 2 * expectedRowCount)
+            capacity <<= 1;
+        this->slots.assign(capacity, 0);
+        this->mask = capacity - 1;
+        this->values.reserve(expectedRowCount * columnCount);
+    }
+
+    /**
+     * @brief Inserts row into the set.
+     *
+     * @return true if the row was not present before
+     */
+    bool insert(const vector<int> &row)
+    {
+        long long slot = this->findSlot(row.data());
+        if (this->slots[slot])
+            return false;
+        this->values.insert(this->values.end(), row.begin(), row.end());
+        this->slots[slot] = ++this->rowCount;
+        if (2 * this->rowCount > this->slots.size())
+            this->grow();
+        return true;
+    }
+};
+
+/**
+ * @brief RowHashSet split into shards on a hash of the row, each shard behind a
+ * lock of its own, so that the workers of a parallel scan insert rows
+ * concurrently.
+ */
+class ShardedRowHashSet
+{
+    int columnCount;
+    vector<RowHashSet> shards;
+    unique_ptr<mutex[]> shardMutexes;
+
+    uint getShard(const vector<int> &row)
+    {
+        uint hash = 0x811C9DC5u;
+        for (int columnCounter = 0; columnCounter < this->columnCount; columnCounter++)
+            hash = (hash ^ (uint)row[columnCounter]) * 0x01000193u;
+        return (hash ^ (hash >> 16)) % this->shards.size();
+    }
+
+public:
+    ShardedRowHashSet(int columnCount, long long expectedRowCount, int shardCount)
+    {
+        this->columnCount = columnCount;
+        this->shards.assign(shardCount, RowHashSet(columnCount, expectedRowCount / shardCount + 1));
+        this->shardMutexes.reset(new mutex[shardCount]);
+    }
+
+    /**
+     * @brief Inserts row into the set.
+     *
+     * @return true if the row was not present before
+     */
+    bool insert(const vector<int> &row)
+    {
+        uint shard = this->getShard(row);
+        lock_guard<mutex> lock(this->shardMutexes[shard]);
+        return this->shards[shard].insert(row);
+    }
+};
+
+/**
+ * @brief Number of rows the operator may keep in memory after reserving a
+ * block each for the input and the output page.
+ */
+static long long getMemoryRowCount(Table *table)
+{
+    return (long long)max((int)MEMORY_BLOCK_COUNT - 2, 1) * table->maxRowsPerBlock;
+}
+
+/**
+ * @brief Writes every distinct row of table once, remembering the rows seen so
+ * far in an in-memory hash set shared by the workers of a parallel scan. With
+ * a single worker it is the first occurrence of every row that is written.
+ */
+static void hashDistinct(Table *table, long long expectedRowCount, PageWriter &writer)
+{
+    logger.log("hashDistinct");
+    int workerCount = getWorkerCount(table);
+    ShardedRowHashSet rowHashSet(table->columnCount, expectedRowCount, workerCount == 1 ? 1 : 4 * workerCount);
+    parallelScan(table, workerCount, [&](int workerIndex, const RowBatch &batch, vector<vector<int>> &output) {
+        for (auto &row : batch)
+            if (rowHashSet.insert(row))
+                output.emplace_back(row);
+    }, &writer);
+}
+
+/**
+ * @brief Hash partitions table on all of its columns so that duplicates land
+ * in the same partition, then removes duplicates partition by partition.
+ * Partitions still too big for memory are partitioned again.
+ */
+static void partitionedDistinct(Table *table, long long estimatedRowCount, PageWriter &writer, int depth)
+{
+    logger.log("partitionedDistinct");
+    const int MAX_PARTITION_DEPTH = 3;
+    long long memoryRowCount = getMemoryRowCount(table);
+    if (estimatedRowCount <= memoryRowCount || depth == MAX_PARTITION_DEPTH)
+    {
+        hashDistinct(table, estimatedRowCount, writer);
+        return;
+    }
+
+    vector<int> columnIndices(table->columnCount);
+    iota(columnIndices.begin(), columnIndices.end(), 0);
+    int partitionCount = min((estimatedRowCount + memoryRowCount - 1) / memoryRowCount, (long long)max((int)MEMORY_BLOCK_COUNT - 1, 2));
+    for (Table *partition : partitionTable(table, columnIndices, partitionCount, depth))
+    {
+        if (!partition)
+            continue;
+        partitionedDistinct(partition, min(partition->rowCount, estimatedRowCount / partitionCount + 1), writer, depth + 1);
+        tableCatalogue.deleteTable(partition->tableName);
+    }
+}
+
+/**
+ * @brief Sorts table on all of its columns with the external sort, after which
+ * duplicates are adjacent and only the first row of every run of equal rows
+ * is written.
+ */
+static void sortDistinct(Table *table, PageWriter &writer)
+{
+    logger.log("sortDistinct");
+    vector<int> columnIndices(table->columnCount);
+    iota(columnIndices.begin(), columnIndices.end(), 0);
+    Table *sortedTable = sortTable(table, tableCatalogue.getTempTableName(table->tableName + "_Sorted"), columnIndices, ASC);
+
+    Cursor cursor = sortedTable->getCursor();
+    vector<int> previousRow;
+    for (RowBatch batch = cursor.getNextBatch(); !batch.empty(); batch = cursor.getNextBatch())
+    {
+        for (auto &row : batch)
+        {
+            if (row != previousRow)
+            {
+                writer.writeRow(row);
+                previousRow = row;
+            }
+        }
+    }
+    tableCatalogue.deleteTable(sortedTable->tableName);
+}
+
 void executeDISTINCT()
 {
     logger.log("executeDISTINCT");
+    Table *table = tableCatalogue.getTable(parsedQuery.distinctRelationName);
+    Table *resultantTable = new Table(parsedQuery.distinctResultRelationName, table->columns);
+    PageWriter writer(resultantTable);
+
+    PhysicalPlan plan = planDistinct(table);
+    if (plan.physicalOperator == HASH_DISTINCT)
+        hashDistinct(table, plan.estimatedRowCount, writer);
+    else if (plan.physicalOperator == PARTITIONED_HASH_DISTINCT)
+        partitionedDistinct(table, plan.estimatedRowCount, writer, 0);
+    else
+        sortDistinct(table, writer);
+
+    writer.close();
+    tableCatalogue.insertTable(resultantTable);
     return;
-}
\ No newline at end of file
+}
@@ -0,0 +1,297 @@
+#include "global.h"
+/**
+ * @brief
+ * SYNTAX: EXPLAIN [ANALYZE] R <- assignment_statement
+ *
+ * EXPLAIN prints the physical plan the statement would be executed with,
+ * without executing it. EXPLAIN ANALYZE executes the statement and reports
+ * what every operator actually did. Operator trees are measured on a serial
+ * run, even for statements that run them on several workers.
+ */
+bool syntacticParseEXPLAIN()
+{
+    logger.log("syntacticParseEXPLAIN");
+    tokenizedQuery.erase(tokenizedQuery.begin());
+    bool explainAnalyze = !tokenizedQuery.empty() && tokenizedQuery.front() == "ANALYZE";
+    if (explainAnalyze)
+        tokenizedQuery.erase(tokenizedQuery.begin());
+    if (tokenizedQuery.size() < 3 || tokenizedQuery[1] != "<-")
+    {
+        cout << "SYNTAX ERROR" << endl;
+        return false;
+    }
+    if (!syntacticParse())
+        return false;
+    parsedQuery.explainQueryType = parsedQuery.queryType;
+    parsedQuery.explainAnalyze = explainAnalyze;
+    parsedQuery.queryType = EXPLAIN;
+    return true;
+}
+
+bool semanticParseEXPLAIN()
+{
+    logger.log("semanticParseEXPLAIN");
+    parsedQuery.queryType = parsedQuery.explainQueryType;
+    bool isValid = semanticParse();
+    parsedQuery.queryType = EXPLAIN;
+    return isValid;
+}
+
+/**
+ * @brief Builds the operator tree of the explained statement if it is executed
+ * by draining one: nested statements, PROJECT, and SELECT when it doesn't use
+ * an index.
+ *
+ * @return unique_ptr<Operator> NULL for statements run by their own executor
+ */
+static unique_ptr<Operator> buildStatementOperator()
+{
+    switch (parsedQuery.explainQueryType)
+    {
+    case PIPELINE:
+        return buildOperator(parsedQuery.pipelinePlan.get());
+    case PROJECTION:
+        return unique_ptr<Operator>(new ProjectOperator(unique_ptr<Operator>(new ScanOperator(tableCatalogue.getTable(parsedQuery.projectionRelationName))), parsedQuery.projectionColumnList));
+    case SELECTION:
+    {
+        Table *table = tableCatalogue.getTable(parsedQuery.selectionRelationName);
+        if (planSelection(table, bindConditions(parsedQuery.selectionConditions, table->columns, table->distinctValuesPerColumnCount)).physicalOperator == INDEX_SCAN)
+            return NULL;
+        return unique_ptr<Operator>(new FilterOperator(unique_ptr<Operator>(new ScanOperator(table)), parsedQuery.selectionConditions));
+    }
+    default:
+        return NULL;
+    }
+}
+
+/**
+ * @brief Number of workers the executor of the explained statement drains its
+ * operator tree with.
+ */
+static int getStatementWorkerCount()
+{
+    switch (parsedQuery.explainQueryType)
+    {
+    case PROJECTION:
+        return getWorkerCount(tableCatalogue.getTable(parsedQuery.projectionRelationName));
+    case SELECTION:
+        return getWorkerCount(tableCatalogue.getTable(parsedQuery.selectionRelationName));
+    default:
+        return 1;
+    }
+}
+
+static string getResultantRelationName()
+{
+    switch (parsedQuery.explainQueryType)
+    {
+    case CROSS:
+        return parsedQuery.crossResultRelationName;
+    case DISTINCT:
+        return parsedQuery.distinctResultRelationName;
+    case GROUPBY:
+        return parsedQuery.groupByResultRelationName;
+    case JOIN:
+        return parsedQuery.joinResultRelationName;
+    case PIPELINE:
+        return parsedQuery.pipelineResultRelationName;
+    case PROJECTION:
+        return parsedQuery.projectionResultRelationName;
+    case SELECTION:
+        return parsedQuery.selectionResultRelationName;
+    case SORT:
+        return parsedQuery.sortResultRelationName;
+    default:
+        return "";
+    }
+}
+
+/**
+ * @brief Plans the explained statement the way its executor does.
+ *
+ * @param plan
+ * @return int number of columns of the resultant relation, 0 if the statement
+ * can't be explained
+ */
+static int planStatement(PhysicalPlan &plan)
+{
+    switch (parsedQuery.explainQueryType)
+    {
+    case CROSS:
+    {
+        Table *table1 = tableCatalogue.getTable(parsedQuery.crossFirstRelationName);
+        Table *table2 = tableCatalogue.getTable(parsedQuery.crossSecondRelationName);
+        plan = planJoin(getJoinInput(table1, -1), getJoinInput(table2, -1), NO_BINOP_CLAUSE);
+        return table1->columnCount + table2->columnCount;
+    }
+    case DISTINCT:
+    {
+        Table *table = tableCatalogue.getTable(parsedQuery.distinctRelationName);
+        plan = planDistinct(table);
+        return table->columnCount;
+    }
+    case GROUPBY:
+    {
+        Table *table = tableCatalogue.getTable(parsedQuery.groupByRelationName);
+        int resultantColumnCount = parsedQuery.groupByAggregates.size() + 1;
+        plan = planGroupBy(table, table->getColumnIndex(parsedQuery.groupByColumnName), resultantColumnCount);
+        plan.detail = parsedQuery.groupByColumnName + " RETURN ";
+        for (int aggregateCounter = 0; aggregateCounter < parsedQuery.groupByAggregates.size(); aggregateCounter++)
+        {
+            Aggregate &aggregate = parsedQuery.groupByAggregates[aggregateCounter];
+            plan.detail += (aggregateCounter ? ", " : "") + getAggregateFunctionName(aggregate.aggregateFunction) + "(" + aggregate.columnName + ")";
+        }
+        return resultantColumnCount;
+    }
+    case JOIN:
+    {
+        Table *table1 = tableCatalogue.getTable(parsedQuery.joinFirstRelationName);
+        Table *table2 = tableCatalogue.getTable(parsedQuery.joinSecondRelationName);
+        JoinInput input1 = getJoinInput(table1, table1->getColumnIndex(parsedQuery.joinFirstColumnName));
+        JoinInput input2 = getJoinInput(table2, table2->getColumnIndex(parsedQuery.joinSecondColumnName));
+        plan = planJoin(input1, input2, parsedQuery.joinBinaryOperator);
+        return table1->columnCount + table2->columnCount;
+    }
+    case PIPELINE:
+    case PROJECTION:
+    {
+        unique_ptr<Operator> root = buildStatementOperator();
+        plan = root->getPlan();
+        return root->columns.size();
+    }
+    case SELECTION:
+    {
+        Table *table = tableCatalogue.getTable(parsedQuery.selectionRelationName);
+        plan = planSelection(table, bindConditions(parsedQuery.selectionConditions, table->columns, table->distinctValuesPerColumnCount));
+        return table->columnCount;
+    }
+    case SORT:
+    {
+        Table *table = tableCatalogue.getTable(parsedQuery.sortRelationName);
+        plan = planSort(table, parsedQuery.sortLimit);
+        plan.detail = "BY " + parsedQuery.sortColumnName + (parsedQuery.sortingStrategy == ASC ? " ASC" : " DESC");
+        if (parsedQuery.sortLimit >= 0)
+            plan.detail += " LIMIT " + to_string(parsedQuery.sortLimit);
+        return table->columnCount;
+    }
+    default:
+        return 0;
+    }
+}
+
+static void printStatistics(const OperatorStatistics &statistics)
+{
+    cout << "pages read: " << statistics.pageReads << ", buffer hits: " << statistics.bufferHits << ", pages written: " << statistics.pageWrites;
+    cout << ", cpu: " << fixed << setprecision(3) << statistics.cpuSeconds * 1000 << " ms";
+}
+
+/**
+ * @brief Records the plan node describing every operator of the tree. Done
+ * before execution, as a scan that has started no longer exposes its table
+ * and the plans of operators above it would change.
+ */
+static void describeOperators(Operator *root, map<Operator *, PhysicalPlan> &plans)
+{
+    plans[root] = root->getPlan();
+    for (Operator *input : root->getInputs())
+        describeOperators(input, plans);
+}
+
+/**
+ * @brief Prints the operator tree after execution with the work done by each
+ * operator itself, i.e. its counters minus those of its inputs. Rows in are
+ * the rows its inputs passed on plus those it read from tables through
+ * cursors.
+ */
+static void printAnalyzedOperator(Operator *root, map<Operator *, PhysicalPlan> &plans, int depth)
+{
+    OperatorStatistics inputStatistics;
+    for (Operator *input : root->getInputs())
+        inputStatistics.add(OperatorStatistics(), input->statistics);
+    OperatorStatistics ownStatistics;
+    ownStatistics.add(inputStatistics, root->statistics);
+
+    cout << string(4 * depth, ' ') << (depth ? "-> " : "") << describePlan(plans[root]);
+    cout << "  (estimated rows: " << root->estimatedRowCount << ", rows in: " << inputStatistics.rowsOut + ownStatistics.rowsRead << ", rows out: " << root->statistics.rowsOut << ", ";
+    printStatistics(ownStatistics);
+    cout << ")" << endl;
+    for (Operator *input : root->getInputs())
+        printAnalyzedOperator(input, plans, depth + 1);
+}
+
+/**
+ * @brief Executes the explained statement. Statements executed as an operator
+ * tree are reported operator by operator. The tree is drained by a single
+ * thread, as the counters of the buffer manager and the CPU time of the
+ * process can't be split between workers, which is said in the report when
+ * the executor would use more than one. The others run their own executor as
+ * a single step, reported after its estimated plan.
+ */
+static void analyzeStatement(const PhysicalPlan &plan)
+{
+    logger.log("analyzeStatement");
+    OperatorStatistics start = OperatorStatistics::getCounters();
+    unique_ptr<Operator> root = buildStatementOperator();
+    if (root)
+    {
+        int workerCount = getStatementWorkerCount();
+        map<Operator *, PhysicalPlan> plans;
+        describeOperators(root.get(), plans);
+        Table *resultantTable = new Table(getResultantRelationName(), root->columns);
+        PageWriter writer(resultantTable);
+        root->drain(writer);
+        if (writer.close())
+            tableCatalogue.insertTable(resultantTable);
+        else
+        {
+            cout << "Empty Table" << endl;
+            resultantTable->unload();
+            delete resultantTable;
+        }
+        printAnalyzedOperator(root.get(), plans, 0);
+        if (workerCount > 1)
+            cout << "Measured on a serial run; the statement runs on " << workerCount << " workers" << endl;
+    }
+    else
+    {
+        parsedQuery.queryType = parsedQuery.explainQueryType;
+        executeCommand();
+        parsedQuery.queryType = EXPLAIN;
+        printPlan(plan);
+    }
+
+    OperatorStatistics total;
+    total.add(start, OperatorStatistics::getCounters());
+    string resultantRelationName = getResultantRelationName();
+    long long resultantRowCount = tableCatalogue.isTable(resultantRelationName) ? tableCatalogue.getTable(resultantRelationName)->rowCount : 0;
+    cout << "Total: rows read: " << total.rowsRead << ", rows out: " << resultantRowCount << ", ";
+    printStatistics(total);
+    cout << endl;
+}
+
+/**
+ * @brief Prints the plan of the explained statement with the estimated block
+ * reads and writes of every node, followed by the totals, or analyzes it.
+ * Writing the resultant table is accounted to the root.
+ */
+void executeEXPLAIN()
+{
+    logger.log("executeEXPLAIN");
+    PhysicalPlan plan;
+    int resultantColumnCount = planStatement(plan);
+    if (!resultantColumnCount)
+    {
+        cout << "EXPLAIN only applies to assignment statements" << endl;
+        return;
+    }
+    uint maxRowsPerBlock = max((uint)((BLOCK_SIZE * 1000) / (sizeof(int) * resultantColumnCount)), 1u);
+    plan.blockWrites += ceil((double)plan.estimatedRowCount / maxRowsPerBlock);
+    if (parsedQuery.explainAnalyze)
+    {
+        analyzeStatement(plan);
+        return;
+    }
+    printPlan(plan);
+    cout << "Estimated block reads: " << (long long)ceil(plan.getTotalBlockReads()) << ", block writes: " << (long long)ceil(plan.getTotalBlockWrites()) << endl;
+    return;
+}
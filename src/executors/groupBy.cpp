@@ -0,0 +1,388 @@
+#include "global.h"
+
+/**
+ * @brief
+ * SYNTAX: R <- GROUP BY column_name FROM relation_name RETURN aggregate_list
+ *
+ * aggregate_list = aggregate_function(column_name) [, aggregate_function(column_name) ...]
+ * aggregate_function = SUM | COUNT | MIN | MAX | AVG
+ *
+ * The resultant relation has the grouping column followed by one column per
+ * aggregate, named after the function and its column (e.g. MAXb).
+ */
+bool syntacticParseGROUPBY()
+{
+    logger.log("syntacticParseGROUPBY");
+    if (tokenizedQuery.size() < 12 || (tokenizedQuery.size() - 8) % 4 || tokenizedQuery[3] != "BY" || tokenizedQuery[5] != "FROM" || tokenizedQuery[7] != "RETURN")
+    {
+        cout << "SYNTAX ERROR" << endl;
+        return false;
+    }
+    parsedQuery.queryType = GROUPBY;
+    parsedQuery.groupByResultRelationName = tokenizedQuery[0];
+    parsedQuery.groupByColumnName = tokenizedQuery[4];
+    parsedQuery.groupByRelationName = tokenizedQuery[6];
+
+    map<string, AggregateFunction> aggregateFunctions = {{"AVG", AVG}, {"COUNT", COUNT}, {"MAX", MAX}, {"MIN", MIN}, {"SUM", SUM}};
+    for (int tokenCounter = 8; tokenCounter < tokenizedQuery.size(); tokenCounter += 4)
+    {
+        auto aggregateFunction = aggregateFunctions.find(tokenizedQuery[tokenCounter]);
+        if (aggregateFunction == aggregateFunctions.end() || tokenizedQuery[tokenCounter + 1] != "(" || tokenizedQuery[tokenCounter + 3] != ")")
+        {
+            cout << "SYNTAX ERROR" << endl;
+            return false;
+        }
+        Aggregate aggregate;
+        aggregate.aggregateFunction = aggregateFunction->second;
+        aggregate.columnName = tokenizedQuery[tokenCounter + 2];
+        parsedQuery.groupByAggregates.emplace_back(aggregate);
+    }
+    return true;
+}
+
+string getAggregateFunctionName(AggregateFunction aggregateFunction)
+{
+    switch (aggregateFunction)
+    {
+    case AVG:
+        return "AVG";
+    case COUNT:
+        return "COUNT";
+    case MAX:
+        return "MAX";
+    case MIN:
+        return "MIN";
+    default:
+        return "SUM";
+    }
+}
+
+/**
+ * @brief Columns of the resultant relation: the grouping column followed by
+ * the aggregates.
+ */
+static vector<string> getGroupByColumns()
+{
+    vector<string> columns = {parsedQuery.groupByColumnName};
+    for (auto &aggregate : parsedQuery.groupByAggregates)
+        columns.emplace_back(getAggregateFunctionName(aggregate.aggregateFunction) + aggregate.columnName);
+    return columns;
+}
+
+bool semanticParseGROUPBY()
+{
+    logger.log("semanticParseGROUPBY");
+    if (tableCatalogue.isTable(parsedQuery.groupByResultRelationName))
+    {
+        cout << "SEMANTIC ERROR: Resultant relation already exists" << endl;
+        return false;
+    }
+
+    if (!tableCatalogue.isTable(parsedQuery.groupByRelationName))
+    {
+        cout << "SEMANTIC ERROR: Relation doesn't exist" << endl;
+        return false;
+    }
+
+    if (!tableCatalogue.isColumnFromTable(parsedQuery.groupByColumnName, parsedQuery.groupByRelationName))
+    {
+        cout << "SEMANTIC ERROR: Column doesn't exist in relation" << endl;
+        return false;
+    }
+
+    for (auto &aggregate : parsedQuery.groupByAggregates)
+    {
+        if (!tableCatalogue.isColumnFromTable(aggregate.columnName, parsedQuery.groupByRelationName))
+        {
+            cout << "SEMANTIC ERROR: Column doesn't exist in relation" << endl;
+            return false;
+        }
+    }
+
+    vector<string> columns = getGroupByColumns();
+    if (set<string>(columns.begin(), columns.end()).size() != columns.size())
+    {
+        cout << "SEMANTIC ERROR: Duplicate column names in resultant relation" << endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Running values of the aggregates of one GROUP BY. The values of a
+ * group are kept as long longs so that sums don't overflow before the group
+ * is complete: the sum for SUM and AVG, the extreme for MIN and MAX. COUNT and
+ * AVG use the row count kept per group.
+ */
+class Aggregation
+{
+    vector<int> columnIndices;
+    vector<AggregateFunction> aggregateFunctions;
+
+public:
+    Aggregation(Table *table, const vector<Aggregate> &aggregates)
+    {
+        for (auto &aggregate : aggregates)
+        {
+            this->columnIndices.emplace_back(table->getColumnIndex(aggregate.columnName));
+            this->aggregateFunctions.emplace_back(aggregate.aggregateFunction);
+        }
+    }
+
+    int getAggregateCount()
+    {
+        return this->aggregateFunctions.size();
+    }
+
+    void start(const vector<int> &row, long long *values)
+    {
+        for (int aggregateCounter = 0; aggregateCounter < this->columnIndices.size(); aggregateCounter++)
+            values[aggregateCounter] = row[this->columnIndices[aggregateCounter]];
+    }
+
+    void update(const vector<int> &row, long long *values)
+    {
+        for (int aggregateCounter = 0; aggregateCounter < this->columnIndices.size(); aggregateCounter++)
+        {
+            int value = row[this->columnIndices[aggregateCounter]];
+            switch (this->aggregateFunctions[aggregateCounter])
+            {
+            case MAX:
+                values[aggregateCounter] = max(values[aggregateCounter], (long long)value);
+                break;
+            case MIN:
+                values[aggregateCounter] = min(values[aggregateCounter], (long long)value);
+                break;
+            default:
+                values[aggregateCounter] += value;
+            }
+        }
+    }
+
+    /**
+     * @brief Combines the values of a group aggregated separately from other
+     * rows of the group into values.
+     */
+    void merge(const long long *otherValues, long long *values)
+    {
+        for (int aggregateCounter = 0; aggregateCounter < this->aggregateFunctions.size(); aggregateCounter++)
+        {
+            switch (this->aggregateFunctions[aggregateCounter])
+            {
+            case MAX:
+                values[aggregateCounter] = max(values[aggregateCounter], otherValues[aggregateCounter]);
+                break;
+            case MIN:
+                values[aggregateCounter] = min(values[aggregateCounter], otherValues[aggregateCounter]);
+                break;
+            default:
+                values[aggregateCounter] += otherValues[aggregateCounter];
+            }
+        }
+    }
+
+    /**
+     * @brief Writes the row of a complete group. AVG is truncated towards zero
+     * like any integer division, SUM is truncated to an int.
+     */
+    void writeGroup(int key, const long long *values, long long rowCount, vector<int> &resultantRow, PageWriter &writer)
+    {
+        resultantRow[0] = key;
+        for (int aggregateCounter = 0; aggregateCounter < this->aggregateFunctions.size(); aggregateCounter++)
+        {
+            if (this->aggregateFunctions[aggregateCounter] == COUNT)
+                resultantRow[aggregateCounter + 1] = rowCount;
+            else if (this->aggregateFunctions[aggregateCounter] == AVG)
+                resultantRow[aggregateCounter + 1] = values[aggregateCounter] / rowCount;
+            else
+                resultantRow[aggregateCounter + 1] = values[aggregateCounter];
+        }
+        writer.writeRow(resultantRow);
+    }
+};
+
+/**
+ * @brief Groups seen by one worker of a hash aggregation: a hash table from
+ * group value to group number, the running values of all groups being stored
+ * back to back in one array.
+ */
+class GroupTable
+{
+    Aggregation *aggregation;
+    int aggregateCount;
+    unordered_map<int, long long> groupNumbers;
+    vector<int> keys;
+    vector<long long> rowCounts;
+    vector<long long> values;
+
+    long long findGroup(int key, bool &isNew)
+    {
+        auto group = this->groupNumbers.emplace(key, this->keys.size());
+        isNew = group.second;
+        if (isNew)
+        {
+            this->keys.emplace_back(key);
+            this->rowCounts.emplace_back(0);
+            this->values.resize(this->values.size() + this->aggregateCount);
+        }
+        return group.first->second;
+    }
+
+public:
+    GroupTable(Aggregation *aggregation, long long expectedGroupCount)
+    {
+        this->aggregation = aggregation;
+        this->aggregateCount = aggregation->getAggregateCount();
+        this->groupNumbers.reserve(expectedGroupCount);
+    }
+
+    void addRow(const vector<int> &row, int columnIndex)
+    {
+        bool isNew;
+        long long groupNumber = this->findGroup(row[columnIndex], isNew);
+        this->rowCounts[groupNumber]++;
+        if (isNew)
+            this->aggregation->start(row, &this->values[groupNumber * this->aggregateCount]);
+        else
+            this->aggregation->update(row, &this->values[groupNumber * this->aggregateCount]);
+    }
+
+    /**
+     * @brief Folds the groups of other, built by another worker, into this one.
+     */
+    void merge(const GroupTable &other)
+    {
+        for (long long otherGroupNumber = 0; otherGroupNumber < other.keys.size(); otherGroupNumber++)
+        {
+            bool isNew;
+            long long groupNumber = this->findGroup(other.keys[otherGroupNumber], isNew);
+            const long long *otherValues = &other.values[otherGroupNumber * this->aggregateCount];
+            if (isNew)
+                copy(otherValues, otherValues + this->aggregateCount, &this->values[groupNumber * this->aggregateCount]);
+            else
+                this->aggregation->merge(otherValues, &this->values[groupNumber * this->aggregateCount]);
+            this->rowCounts[groupNumber] += other.rowCounts[otherGroupNumber];
+        }
+    }
+
+    void write(PageWriter &writer)
+    {
+        vector<int> resultantRow(this->aggregateCount + 1);
+        for (long long groupNumber = 0; groupNumber < this->keys.size(); groupNumber++)
+            this->aggregation->writeGroup(this->keys[groupNumber], &this->values[groupNumber * this->aggregateCount], this->rowCounts[groupNumber], resultantRow, writer);
+    }
+};
+
+/**
+ * @brief Aggregates table in memory with a parallel scan. Every worker
+ * aggregates the morsels it reads into a group table of its own and the group
+ * tables are merged once the scan is over.
+ */
+static void hashGroupBy(Table *table, int columnIndex, Aggregation &aggregation, long long expectedGroupCount, PageWriter &writer)
+{
+    logger.log("hashGroupBy");
+    int workerCount = getWorkerCount(table);
+    vector<GroupTable> groupTables(workerCount, GroupTable(&aggregation, expectedGroupCount));
+    parallelScan(table, workerCount, [&](int workerIndex, const RowBatch &batch, vector<vector<int>> &output) {
+        for (auto &row : batch)
+            groupTables[workerIndex].addRow(row, columnIndex);
+    });
+    for (int workerCounter = 1; workerCounter < workerCount; workerCounter++)
+        groupTables[0].merge(groupTables[workerCounter]);
+    groupTables[0].write(writer);
+}
+
+/**
+ * @brief Hash partitions table on the grouping column so that every group lands
+ * in one partition, then aggregates partition by partition. Partitions still
+ * holding too many groups are partitioned again.
+ */
+static void partitionedGroupBy(Table *table, int columnIndex, Aggregation &aggregation, long long estimatedGroupCount, long long memoryGroupCount, PageWriter &writer, int depth)
+{
+    logger.log("partitionedGroupBy");
+    const int MAX_PARTITION_DEPTH = 3;
+    if (estimatedGroupCount <= memoryGroupCount || depth == MAX_PARTITION_DEPTH)
+    {
+        hashGroupBy(table, columnIndex, aggregation, estimatedGroupCount, writer);
+        return;
+    }
+
+    int partitionCount = min((estimatedGroupCount + memoryGroupCount - 1) / memoryGroupCount, (long long)max((int)MEMORY_BLOCK_COUNT - 1, 2));
+    for (Table *partition : partitionTable(table, {columnIndex}, partitionCount, depth))
+    {
+        if (!partition)
+            continue;
+        partitionedGroupBy(partition, columnIndex, aggregation, min(partition->rowCount, estimatedGroupCount / partitionCount + 1), memoryGroupCount, writer, depth + 1);
+        tableCatalogue.deleteTable(partition->tableName);
+    }
+}
+
+/**
+ * @brief Aggregates a table stored in order of the grouping column, whose
+ * groups are runs of adjacent rows. Only the group being read is held in
+ * memory.
+ */
+static void sortedGroupBy(Table *table, int columnIndex, Aggregation &aggregation, PageWriter &writer)
+{
+    logger.log("sortedGroupBy");
+    vector<long long> values(aggregation.getAggregateCount());
+    vector<int> resultantRow(aggregation.getAggregateCount() + 1);
+    long long rowCount = 0;
+    int key = 0;
+
+    Cursor cursor = table->getCursor();
+    for (RowBatch batch = cursor.getNextBatch(); !batch.empty(); batch = cursor.getNextBatch())
+    {
+        for (auto &row : batch)
+        {
+            if (rowCount && row[columnIndex] == key)
+            {
+                rowCount++;
+                aggregation.update(row, values.data());
+                continue;
+            }
+            if (rowCount)
+                aggregation.writeGroup(key, values.data(), rowCount, resultantRow, writer);
+            key = row[columnIndex];
+            rowCount = 1;
+            aggregation.start(row, values.data());
+        }
+    }
+    if (rowCount)
+        aggregation.writeGroup(key, values.data(), rowCount, resultantRow, writer);
+}
+
+void executeGROUPBY()
+{
+    logger.log("executeGROUPBY");
+    Table *table = tableCatalogue.getTable(parsedQuery.groupByRelationName);
+    int columnIndex = table->getColumnIndex(parsedQuery.groupByColumnName);
+    Table *resultantTable = new Table(parsedQuery.groupByResultRelationName, getGroupByColumns());
+    PageWriter writer(resultantTable);
+    Aggregation aggregation(table, parsedQuery.groupByAggregates);
+
+    PhysicalPlan plan = planGroupBy(table, columnIndex, resultantTable->columnCount);
+    if (plan.physicalOperator == HASH_GROUP_BY)
+        hashGroupBy(table, columnIndex, aggregation, plan.estimatedRowCount, writer);
+    else if (plan.physicalOperator == PARTITIONED_HASH_GROUP_BY)
+    {
+        long long memoryGroupCount = (long long)max((int)MEMORY_BLOCK_COUNT - 2, 1) * resultantTable->maxRowsPerBlock;
+        partitionedGroupBy(table, columnIndex, aggregation, plan.estimatedRowCount, memoryGroupCount, writer, 0);
+    }
+    else if (table->sortedColumn == parsedQuery.groupByColumnName)
+    {
+        sortedGroupBy(table, columnIndex, aggregation, writer);
+        resultantTable->sortedColumn = parsedQuery.groupByColumnName;
+    }
+    else
+    {
+        Table *sortedTable = sortTable(table, tableCatalogue.getTempTableName(table->tableName + "_Sorted"), {columnIndex}, ASC);
+        sortedGroupBy(sortedTable, columnIndex, aggregation, writer);
+        tableCatalogue.deleteTable(sortedTable->tableName);
+        resultantTable->sortedColumn = parsedQuery.groupByColumnName;
+    }
+
+    writer.close();
+    tableCatalogue.insertTable(resultantTable);
+    return;
+}
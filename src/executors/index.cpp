@@ -2,7 +2,7 @@
 /**
  * @brief 
  * SYNTAX: INDEX ON column_name FROM relation_name USING indexing_strategy
- * indexing_strategy: ASC | DESC | NOTHING
+ * indexing_strategy: BTREE | HASH | BITMAP | NOTHING
  */
 bool syntacticParseINDEX()
 {
@@ -20,6 +20,8 @@ bool syntacticParseINDEX()
         parsedQuery.indexingStrategy = BTREE;
     else if (indexingStrategy == "HASH")
         parsedQuery.indexingStrategy = HASH;
+    else if (indexingStrategy == "BITMAP")
+        parsedQuery.indexingStrategy = BITMAP;
     else if (indexingStrategy == "NOTHING")
         parsedQuery.indexingStrategy = NOTHING;
     else
@@ -44,15 +46,60 @@ bool semanticParseINDEX()
         return false;
     }
     Table* table = tableCatalogue.getTable(parsedQuery.indexRelationName);
-    if(table->indexed){
+    if(table->indexed && parsedQuery.indexingStrategy != NOTHING){
         cout << "SEMANTIC ERROR: Table already indexed" << endl;
         return false;
     }
+    if(table->indexed && table->indexedColumn != parsedQuery.indexColumnName){
+        cout << "SEMANTIC ERROR: Table not indexed on column" << endl;
+        return false;
+    }
     return true;
 }
 
+/**
+ * @brief Builds the index requested by the INDEX command. Using NOTHING removes
+ * the index of the table, if any.
+ */
 void executeINDEX()
 {
     logger.log("executeINDEX");
+    Table* table = tableCatalogue.getTable(parsedQuery.indexRelationName);
+    if (table->index)
+    {
+        table->index->unload();
+        delete table->index;
+        table->index = NULL;
+    }
+    table->indexed = false;
+    table->indexedColumn = "";
+    table->indexingStrategy = NOTHING;
+
+    string indexName = table->tableName + "_" + parsedQuery.indexColumnName;
+    int columnIndex = table->getColumnIndex(parsedQuery.indexColumnName);
+    if (parsedQuery.indexingStrategy == BTREE)
+    {
+        BPlusTree* bPlusTree = new BPlusTree(indexName);
+        bPlusTree->bulkLoad(table, columnIndex);
+        table->index = bPlusTree;
+    }
+    else if (parsedQuery.indexingStrategy == HASH)
+    {
+        HashIndex* hashIndex = new HashIndex(indexName);
+        hashIndex->build(table, columnIndex);
+        table->index = hashIndex;
+    }
+    else if (parsedQuery.indexingStrategy == BITMAP)
+    {
+        BitmapIndex* bitmapIndex = new BitmapIndex();
+        bitmapIndex->build(table, columnIndex);
+        table->index = bitmapIndex;
+    }
+    else
+        return;
+
+    table->indexed = true;
+    table->indexedColumn = parsedQuery.indexColumnName;
+    table->indexingStrategy = parsedQuery.indexingStrategy;
     return;
 }
\ No newline at end of file
@@ -63,8 +63,336 @@ bool semanticParseJOIN()
     return true;
 }
 
+/**
+ * @brief Hash of the given columns of row used to spread rows over partitions.
+ * Every recursion level of a partitioning operator uses a different seed so a
+ * partition that is too big to fit in memory gets split differently the next
+ * time around.
+ */
+static uint partitionHash(const vector<int> &row, const vector<int> &columnIndices, int seed)
+{
+    uint hash = (uint)seed * 0x85EBCA77u;
+    for (int columnIndex : columnIndices)
+    {
+        hash = (hash ^ (uint)row[columnIndex]) * 0x9E3779B1u;
+        hash ^= hash >> 15;
+    }
+    hash *= 0xC2B2AE3Du;
+    hash ^= hash >> 13;
+    return hash;
+}
+
+/**
+ * @brief Joins the two relations by loading the build relation into an in
+ * memory hash table on the join column and streaming the probe relation past
+ * it, with a parallel scan.
+ */
+static void inMemoryHashJoin(Table *buildTable, int buildColumnIndex, Table *probeTable, int probeColumnIndex, bool buildIsFirst, PageWriter &writer)
+{
+    logger.log("inMemoryHashJoin");
+    unordered_map<int, vector<vector<int>>> hashTable;
+    hashTable.reserve(buildTable->rowCount);
+    Cursor buildCursor = buildTable->getCursor();
+    for (RowBatch batch = buildCursor.getNextBatch(); !batch.empty(); batch = buildCursor.getNextBatch())
+        for (auto &row : batch)
+            hashTable[row[buildColumnIndex]].emplace_back(row);
+
+    //The hash table is only read from here on, the probe runs in parallel
+    parallelScan(probeTable, getWorkerCount(probeTable), [&](int workerIndex, const RowBatch &batch, vector<vector<int>> &output) {
+        for (auto &row : batch)
+        {
+            auto bucket = hashTable.find(row[probeColumnIndex]);
+            if (bucket == hashTable.end())
+                continue;
+            for (auto &buildRow : bucket->second)
+            {
+                const vector<int> &firstRow = buildIsFirst ? buildRow : row;
+                const vector<int> &secondRow = buildIsFirst ? row : buildRow;
+                output.emplace_back(firstRow);
+                output.back().insert(output.back().end(), secondRow.begin(), secondRow.end());
+            }
+        }
+    }, &writer);
+}
+
+/**
+ * @brief Splits table into partitionCount temporary tables on the hash of the
+ * columns in columnIndices, so rows agreeing on those columns end up in the
+ * same partition. Every partition keeps one page in memory while it is being
+ * written. Partitions that end up empty are dropped and returned as NULL.
+ *
+ * @param table
+ * @param columnIndices
+ * @param partitionCount
+ * @param seed
+ * @return vector<Table *>
+ */
+vector<Table *> partitionTable(Table *table, vector<int> columnIndices, int partitionCount, int seed)
+{
+    logger.log("partitionTable");
+    vector<Table *> partitions(partitionCount);
+    vector<PageWriter> writers;
+    writers.reserve(partitionCount);
+    for (int partitionCounter = 0; partitionCounter < partitionCount; partitionCounter++)
+    {
+        partitions[partitionCounter] = new Table(tableCatalogue.getTempTableName(table->tableName + "_Partition"), table->columns);
+        tableCatalogue.insertTable(partitions[partitionCounter]);
+        writers.emplace_back(partitions[partitionCounter]);
+    }
+
+    Cursor cursor = table->getCursor();
+    for (RowBatch batch = cursor.getNextBatch(); !batch.empty(); batch = cursor.getNextBatch())
+        for (auto &row : batch)
+            writers[partitionHash(row, columnIndices, seed) % partitionCount].writeRow(row);
+
+    for (int partitionCounter = 0; partitionCounter < partitionCount; partitionCounter++)
+    {
+        if (!writers[partitionCounter].close())
+        {
+            tableCatalogue.deleteTable(partitions[partitionCounter]->tableName);
+            partitions[partitionCounter] = NULL;
+        }
+    }
+    return partitions;
+}
+
+/**
+ * @brief Equi-join of the build and probe relations. If the build relation fits
+ * in the memory left after reserving a block each for the probe and output
+ * pages, it is joined in memory. Otherwise both relations are partitioned to
+ * disk on the hash of the join column (grace hash join) and every pair of
+ * partitions is joined recursively. Partitions that refuse to shrink (all rows
+ * share one key) are joined in memory once MAX_PARTITION_DEPTH is reached.
+ */
+static void hashJoin(Table *buildTable, int buildColumnIndex, Table *probeTable, int probeColumnIndex, bool buildIsFirst, PageWriter &writer, int depth)
+{
+    logger.log("hashJoin");
+    const int MAX_PARTITION_DEPTH = 3;
+    int memoryBlockCount = max((int)MEMORY_BLOCK_COUNT - 2, 1);
+    if (buildTable->blockCount <= memoryBlockCount || depth == MAX_PARTITION_DEPTH)
+    {
+        inMemoryHashJoin(buildTable, buildColumnIndex, probeTable, probeColumnIndex, buildIsFirst, writer);
+        return;
+    }
+
+    //Every partition keeps one output page in memory while partitioning
+    int partitionCount = min((buildTable->blockCount + memoryBlockCount - 1) / memoryBlockCount, max((uint)MEMORY_BLOCK_COUNT - 1, 2u));
+    vector<Table *> buildPartitions = partitionTable(buildTable, {buildColumnIndex}, partitionCount, depth);
+    vector<Table *> probePartitions = partitionTable(probeTable, {probeColumnIndex}, partitionCount, depth);
+    for (int partitionCounter = 0; partitionCounter < partitionCount; partitionCounter++)
+    {
+        Table *buildPartition = buildPartitions[partitionCounter];
+        Table *probePartition = probePartitions[partitionCounter];
+        if (buildPartition && probePartition)
+        {
+            //The smaller partition of the pair becomes the build side
+            if (buildPartition->rowCount <= probePartition->rowCount)
+                hashJoin(buildPartition, buildColumnIndex, probePartition, probeColumnIndex, buildIsFirst, writer, depth + 1);
+            else
+                hashJoin(probePartition, probeColumnIndex, buildPartition, buildColumnIndex, !buildIsFirst, writer, depth + 1);
+        }
+        if (buildPartition)
+            tableCatalogue.deleteTable(buildPartition->tableName);
+        if (probePartition)
+            tableCatalogue.deleteTable(probePartition->tableName);
+    }
+}
+
+/**
+ * @brief Returns a cursor positioned at the row with index rowIndex of a table
+ * written by PageWriter, i.e. a table whose pages are all full except the last.
+ */
+static Cursor getCursorAt(Table *table, long long rowIndex)
+{
+    Cursor cursor(table->tableName, rowIndex / table->maxRowsPerBlock);
+    cursor.pagePointer = rowIndex % table->maxRowsPerBlock;
+    return cursor;
+}
+
+/**
+ * @brief Tracks the number of rows of a sorted relation whose join value is
+ * below (or not above) a probe value. As the probe values arrive in ascending
+ * order the boundary only ever moves forward, so advancing it for all probes
+ * together costs a single scan of the relation.
+ */
+class SortedBoundary
+{
+    Cursor cursor;
+    vector<int> row;
+    int columnIndex;
+    bool inclusive;
+
+public:
+    long long position = 0;
+
+    SortedBoundary(Table *table, int columnIndex, bool inclusive) : cursor(table->getCursor())
+    {
+        this->columnIndex = columnIndex;
+        this->inclusive = inclusive;
+        this->row = this->cursor.getNext();
+    }
+
+    void advance(int value)
+    {
+        while (!this->row.empty() && (this->row[this->columnIndex] < value || (this->inclusive && this->row[this->columnIndex] == value)))
+        {
+            this->position++;
+            this->row = this->cursor.getNext();
+        }
+    }
+};
+
+/**
+ * @brief Joins the outer row with the rows [from, to) of the sorted inner
+ * relation.
+ */
+static void writeJoinedRange(const vector<int> &outerRow, Table *innerTable, long long from, long long to, vector<int> &resultantRow, PageWriter &writer)
+{
+    if (from >= to)
+        return;
+    Cursor cursor = getCursorAt(innerTable, from);
+    for (long long rowCounter = from; rowCounter < to; rowCounter++)
+        writeJoinedRow(outerRow, cursor.getNext(), true, resultantRow, writer);
+}
+
+/**
+ * @brief Sort merge join, also used as a band join for the <, <=, >, >= and !=
+ * operators. Both relations are sorted on their join column with the external
+ * sort, after which the inner rows matching an outer value form a contiguous
+ * window of the sorted inner relation: the run of equal values for ==, a
+ * suffix for < and <=, a prefix for > and >=, and everything but the run of
+ * equal values for !=. The window boundaries move forward
+ * monotonically with the outer values, so no inner row is compared twice and
+ * the remaining work is proportional to the size of the result.
+ */
+static void sortMergeJoin(Table *table1, int firstColumnIndex, Table *table2, int secondColumnIndex, BinaryOperator binaryOperator, PageWriter &writer)
+{
+    logger.log("sortMergeJoin");
+    Table *sortedTable1 = sortTable(table1, tableCatalogue.getTempTableName(table1->tableName + "_Sorted"), {firstColumnIndex}, ASC);
+    Table *sortedTable2 = sortTable(table2, tableCatalogue.getTempTableName(table2->tableName + "_Sorted"), {secondColumnIndex}, ASC);
+
+    //Number of inner rows with value < outer value and with value <= outer value
+    SortedBoundary lowerBound(sortedTable2, secondColumnIndex, false);
+    SortedBoundary upperBound(sortedTable2, secondColumnIndex, true);
+    long long innerRowCount = sortedTable2->rowCount;
+
+    vector<int> resultantRow;
+    Cursor cursor = sortedTable1->getCursor();
+    for (RowBatch batch = cursor.getNextBatch(); !batch.empty(); batch = cursor.getNextBatch())
+    {
+        for (auto &row : batch)
+        {
+            int value = row[firstColumnIndex];
+            lowerBound.advance(value);
+            upperBound.advance(value);
+            switch (binaryOperator)
+            {
+            case LESS_THAN:
+                writeJoinedRange(row, sortedTable2, upperBound.position, innerRowCount, resultantRow, writer);
+                break;
+            case LEQ:
+                writeJoinedRange(row, sortedTable2, lowerBound.position, innerRowCount, resultantRow, writer);
+                break;
+            case GREATER_THAN:
+                writeJoinedRange(row, sortedTable2, 0, lowerBound.position, resultantRow, writer);
+                break;
+            case GEQ:
+                writeJoinedRange(row, sortedTable2, 0, upperBound.position, resultantRow, writer);
+                break;
+            case EQUAL:
+                writeJoinedRange(row, sortedTable2, lowerBound.position, upperBound.position, resultantRow, writer);
+                break;
+            case NOT_EQUAL:
+                writeJoinedRange(row, sortedTable2, 0, lowerBound.position, resultantRow, writer);
+                writeJoinedRange(row, sortedTable2, upperBound.position, innerRowCount, resultantRow, writer);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    tableCatalogue.deleteTable(sortedTable1->tableName);
+    tableCatalogue.deleteTable(sortedTable2->tableName);
+}
+
+/**
+ * @brief Equi-join that streams the outer relation and searches the index on
+ * the join column of the inner relation for every outer row, fetching only
+ * the inner pages that hold matches.
+ */
+static void indexNestedLoopJoin(Table *outerTable, int outerColumnIndex, Table *innerTable, bool outerIsFirst, PageWriter &writer)
+{
+    logger.log("indexNestedLoopJoin");
+    vector<int> resultantRow;
+    Cursor cursor = outerTable->getCursor();
+    for (RowBatch batch = cursor.getNextBatch(); !batch.empty(); batch = cursor.getNextBatch())
+    {
+        for (auto &row : batch)
+        {
+            int value = row[outerColumnIndex];
+            for (auto &innerRow : innerTable->getRows(innerTable->index->search(value, value)))
+                writeJoinedRow(innerRow, row, !outerIsFirst, resultantRow, writer);
+        }
+    }
+}
+
+/**
+ * @brief Writes the join of table1 and table2 on firstColumn binaryOperator
+ * secondColumn to writer, with the algorithm chosen by planJoin.
+ *
+ * @param table1
+ * @param firstColumnIndex
+ * @param table2
+ * @param secondColumnIndex
+ * @param binaryOperator
+ * @param writer
+ */
+void joinTables(Table *table1, int firstColumnIndex, Table *table2, int secondColumnIndex, BinaryOperator binaryOperator, PageWriter &writer)
+{
+    logger.log("joinTables");
+    PhysicalPlan plan = planJoin(getJoinInput(table1, firstColumnIndex), getJoinInput(table2, secondColumnIndex), binaryOperator);
+    switch (plan.physicalOperator)
+    {
+    case HASH_JOIN:
+        if (plan.firstIsOuter)
+            hashJoin(table1, firstColumnIndex, table2, secondColumnIndex, true, writer, 0);
+        else
+            hashJoin(table2, secondColumnIndex, table1, firstColumnIndex, false, writer, 0);
+        break;
+    case INDEX_NESTED_LOOP_JOIN:
+        if (plan.firstIsOuter)
+            indexNestedLoopJoin(table1, firstColumnIndex, table2, true, writer);
+        else
+            indexNestedLoopJoin(table2, secondColumnIndex, table1, false, writer);
+        break;
+    case SORT_MERGE_JOIN:
+        sortMergeJoin(table1, firstColumnIndex, table2, secondColumnIndex, binaryOperator, writer);
+        break;
+    default:
+        blockNestedLoopJoin(table1, firstColumnIndex, table2, secondColumnIndex, binaryOperator, writer);
+    }
+}
+
 void executeJOIN()
 {
     logger.log("executeJOIN");
+
+    Table *table1 = tableCatalogue.getTable(parsedQuery.joinFirstRelationName);
+    Table *table2 = tableCatalogue.getTable(parsedQuery.joinSecondRelationName);
+    int firstColumnIndex = table1->getColumnIndex(parsedQuery.joinFirstColumnName);
+    int secondColumnIndex = table2->getColumnIndex(parsedQuery.joinSecondColumnName);
+
+    Table *resultantTable = new Table(parsedQuery.joinResultRelationName, getJoinColumns(table1, table2));
+    PageWriter writer(resultantTable);
+    joinTables(table1, firstColumnIndex, table2, secondColumnIndex, parsedQuery.joinBinaryOperator, writer);
+    if (writer.close())
+        tableCatalogue.insertTable(resultantTable);
+    else
+    {
+        cout << "Empty Table" << endl;
+        resultantTable->unload();
+        delete resultantTable;
+    }
     return;
-}
\ No newline at end of file
+}
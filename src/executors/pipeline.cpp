@@ -0,0 +1,325 @@
+#include "global.h"
+
+/**
+ * @brief Parses tokens, either a relation name or a statement without its
+ * resultant relation, into a plan node. Nested statements in parentheses are
+ * parsed first and replaced by placeholder names, after which the statement is
+ * handed to the syntactic parser of its kind.
+ *
+ * @return shared_ptr<PlanNode> NULL on syntax errors
+ */
+static shared_ptr<PlanNode> parsePlanNode(vector<string> tokens)
+{
+    logger.log("parsePlanNode");
+    while (tokens.size() >= 2 && tokens.front() == "(" && tokens.back() == ")")
+    {
+        //Strip the parentheses only if they enclose everything
+        int depth = 0, closingIndex = -1;
+        for (int tokenIndex = 0; tokenIndex < tokens.size() && closingIndex < 0; tokenIndex++)
+        {
+            depth += (tokens[tokenIndex] == "(") - (tokens[tokenIndex] == ")");
+            if (!depth)
+                closingIndex = tokenIndex;
+        }
+        if (closingIndex != tokens.size() - 1)
+            break;
+        tokens = vector<string>(tokens.begin() + 1, tokens.end() - 1);
+    }
+
+    shared_ptr<PlanNode> node(new PlanNode());
+    if (tokens.size() == 1 && tokens[0] != "(" && tokens[0] != ")")
+    {
+        node->relationName = tokens[0];
+        return node;
+    }
+
+    vector<string> statement = {"#", "<-"};
+    for (int tokenIndex = 0; tokenIndex < tokens.size(); tokenIndex++)
+    {
+        if (tokens[tokenIndex] == ")")
+        {
+            cout << "SYNTAX ERROR" << endl;
+            return NULL;
+        }
+        if (tokens[tokenIndex] != "(")
+        {
+            statement.emplace_back(tokens[tokenIndex]);
+            continue;
+        }
+        int depth = 0, closingIndex = -1;
+        for (int nestedIndex = tokenIndex; nestedIndex < tokens.size() && closingIndex < 0; nestedIndex++)
+        {
+            depth += (tokens[nestedIndex] == "(") - (tokens[nestedIndex] == ")");
+            if (!depth)
+                closingIndex = nestedIndex;
+        }
+        if (closingIndex < 0)
+        {
+            cout << "SYNTAX ERROR" << endl;
+            return NULL;
+        }
+        shared_ptr<PlanNode> child = parsePlanNode(vector<string>(tokens.begin() + tokenIndex + 1, tokens.begin() + closingIndex));
+        if (!child)
+            return NULL;
+        statement.emplace_back("#" + to_string(node->children.size()));
+        node->children.emplace_back(child);
+        tokenIndex = closingIndex;
+    }
+    if (statement.size() < 3)
+    {
+        cout << "SYNTAX ERROR" << endl;
+        return NULL;
+    }
+
+    tokenizedQuery = statement;
+    parsedQuery.clear();
+    bool isParsed;
+    if (statement[2] == "SELECT")
+        isParsed = syntacticParseSELECTION();
+    else if (statement[2] == "PROJECT")
+        isParsed = syntacticParsePROJECTION();
+    else if (statement[2] == "CROSS")
+        isParsed = syntacticParseCROSS();
+    else if (statement[2] == "JOIN")
+        isParsed = syntacticParseJOIN();
+    else if (statement[2] == "SORT")
+        isParsed = syntacticParseSORT();
+    else
+    {
+        cout << "SYNTAX ERROR" << endl;
+        return NULL;
+    }
+    if (!isParsed)
+        return NULL;
+    node->query = parsedQuery;
+    return node;
+}
+
+/**
+ * @brief 
+ * SYNTAX: R <- statement
+ * where the relations read by a SELECT, PROJECT, CROSS, JOIN or SORT statement
+ * may themselves be such statements in parentheses, e.g.
+ * R <- PROJECT a, b FROM (SELECT a > 5 AND b < 3 FROM T)
+ * A nested statement takes the name of its leftmost relation when its columns
+ * have to be told apart from those of another relation in a CROSS or JOIN.
+ */
+bool syntacticParsePIPELINE()
+{
+    logger.log("syntacticParsePIPELINE");
+    vector<string> query = tokenizedQuery;
+    shared_ptr<PlanNode> plan = parsePlanNode(vector<string>(query.begin() + 2, query.end()));
+    tokenizedQuery = query;
+    parsedQuery.clear();
+    if (!plan)
+        return false;
+    parsedQuery.queryType = PIPELINE;
+    parsedQuery.pipelineResultRelationName = query[0];
+    parsedQuery.pipelinePlan = plan;
+    return true;
+}
+
+/**
+ * @brief Returns the nested statement of node named relationName.
+ *
+ * @return PlanNode* NULL if relationName names a table
+ */
+static PlanNode *getChild(PlanNode *node, string relationName)
+{
+    for (int childCounter = 0; childCounter < node->children.size(); childCounter++)
+        if (relationName == "#" + to_string(childCounter))
+            return node->children[childCounter].get();
+    return NULL;
+}
+
+/**
+ * @brief Builds the operator reading relationName, either a placeholder of a
+ * nested statement of node or a table.
+ */
+static unique_ptr<Operator> buildInput(PlanNode *node, string relationName)
+{
+    PlanNode *child = getChild(node, relationName);
+    if (child)
+        return buildOperator(child);
+    if (!tableCatalogue.isTable(relationName))
+    {
+        cout << "SEMANTIC ERROR: Relation doesn't exist" << endl;
+        return NULL;
+    }
+    return unique_ptr<Operator>(new ScanOperator(tableCatalogue.getTable(relationName)));
+}
+
+static bool isColumnOf(Operator *input, string columnName)
+{
+    if (input->getColumnIndex(columnName) >= 0)
+        return true;
+    cout << "SEMANTIC ERROR: Column doesn't exist in relation" << endl;
+    return false;
+}
+
+/**
+ * @brief Builds a selection over a cross product. If the condition has no OR
+ * and one of its comparisons compares a column of each side of the cross
+ * product, the pair is rewritten into a join on that comparison so the cross
+ * product is never formed. Equality is preferred, as it allows hashing. The
+ * other comparisons are checked by a filter above the join.
+ */
+static unique_ptr<Operator> buildCrossSelection(PlanNode *crossNode, const vector<vector<SelectionCondition>> &conditions)
+{
+    logger.log("buildCrossSelection");
+    ParsedQuery &crossQuery = crossNode->query;
+    unique_ptr<Operator> left = buildInput(crossNode, crossQuery.crossFirstRelationName);
+    unique_ptr<Operator> right = left ? buildInput(crossNode, crossQuery.crossSecondRelationName) : NULL;
+    if (!right)
+        return NULL;
+    vector<string> columns = getJoinColumns(left->relationName, left->columns, right->relationName, right->columns);
+    int leftColumnCount = left->columns.size();
+    auto getColumnIndex = [&](string columnName) { return (int)(find(columns.begin(), columns.end(), columnName) - columns.begin()); };
+
+    int joinConditionIndex = -1;
+    for (auto &conjunction : conditions)
+    {
+        for (int conditionCounter = 0; conditionCounter < conjunction.size(); conditionCounter++)
+        {
+            const SelectionCondition &condition = conjunction[conditionCounter];
+            int firstColumnIndex = getColumnIndex(condition.firstColumnName);
+            int secondColumnIndex = condition.selectType == COLUMN ? getColumnIndex(condition.secondColumnName) : 0;
+            if (firstColumnIndex == columns.size() || secondColumnIndex == columns.size())
+            {
+                cout << "SEMANTIC ERROR: Column doesn't exist in relation" << endl;
+                return NULL;
+            }
+            if (conditions.size() != 1 || condition.selectType != COLUMN || (firstColumnIndex < leftColumnCount) == (secondColumnIndex < leftColumnCount))
+                continue;
+            if (joinConditionIndex < 0 || (condition.binaryOperator == EQUAL && conjunction[joinConditionIndex].binaryOperator != EQUAL))
+                joinConditionIndex = conditionCounter;
+        }
+    }
+    if (joinConditionIndex < 0)
+        return unique_ptr<Operator>(new FilterOperator(unique_ptr<Operator>(new JoinOperator(move(left), move(right), -1, -1, NO_BINOP_CLAUSE)), conditions));
+
+    vector<SelectionCondition> remainingConditions = conditions.front();
+    SelectionCondition joinCondition = remainingConditions[joinConditionIndex];
+    remainingConditions.erase(remainingConditions.begin() + joinConditionIndex);
+    int leftColumnIndex = getColumnIndex(joinCondition.firstColumnName);
+    int rightColumnIndex = getColumnIndex(joinCondition.secondColumnName);
+    BinaryOperator binaryOperator = joinCondition.binaryOperator;
+    if (leftColumnIndex >= leftColumnCount)
+    {
+        swap(leftColumnIndex, rightColumnIndex);
+        binaryOperator = mirrorBinaryOperator(binaryOperator);
+    }
+    unique_ptr<Operator> join(new JoinOperator(move(left), move(right), leftColumnIndex, rightColumnIndex - leftColumnCount, binaryOperator));
+    if (remainingConditions.empty())
+        return join;
+    return unique_ptr<Operator>(new FilterOperator(move(join), {remainingConditions}));
+}
+
+/**
+ * @brief Builds the operator tree of a plan node, checking that the relations
+ * and columns it refers to exist. No rows are read until the tree is drained.
+ *
+ * @return unique_ptr<Operator> NULL on semantic errors
+ */
+unique_ptr<Operator> buildOperator(PlanNode *node)
+{
+    logger.log("buildOperator");
+    if (!node->relationName.empty())
+        return buildInput(node, node->relationName);
+
+    ParsedQuery &query = node->query;
+    switch (query.queryType)
+    {
+    case SELECTION:
+    {
+        PlanNode *child = getChild(node, query.selectionRelationName);
+        if (child && child->relationName.empty() && child->query.queryType == CROSS)
+            return buildCrossSelection(child, query.selectionConditions);
+        unique_ptr<Operator> input = buildInput(node, query.selectionRelationName);
+        if (!input)
+            return NULL;
+        for (auto &conjunction : query.selectionConditions)
+            for (auto &condition : conjunction)
+                if (!isColumnOf(input.get(), condition.firstColumnName) || (condition.selectType == COLUMN && !isColumnOf(input.get(), condition.secondColumnName)))
+                    return NULL;
+        return unique_ptr<Operator>(new FilterOperator(move(input), query.selectionConditions));
+    }
+    case PROJECTION:
+    {
+        unique_ptr<Operator> input = buildInput(node, query.projectionRelationName);
+        if (!input)
+            return NULL;
+        for (auto &columnName : query.projectionColumnList)
+            if (!isColumnOf(input.get(), columnName))
+                return NULL;
+        return unique_ptr<Operator>(new ProjectOperator(move(input), query.projectionColumnList));
+    }
+    case CROSS:
+    {
+        unique_ptr<Operator> left = buildInput(node, query.crossFirstRelationName);
+        unique_ptr<Operator> right = left ? buildInput(node, query.crossSecondRelationName) : NULL;
+        if (!right)
+            return NULL;
+        return unique_ptr<Operator>(new JoinOperator(move(left), move(right), -1, -1, NO_BINOP_CLAUSE));
+    }
+    case JOIN:
+    {
+        unique_ptr<Operator> left = buildInput(node, query.joinFirstRelationName);
+        unique_ptr<Operator> right = left ? buildInput(node, query.joinSecondRelationName) : NULL;
+        if (!right || !isColumnOf(left.get(), query.joinFirstColumnName) || !isColumnOf(right.get(), query.joinSecondColumnName))
+            return NULL;
+        int leftColumnIndex = left->getColumnIndex(query.joinFirstColumnName);
+        int rightColumnIndex = right->getColumnIndex(query.joinSecondColumnName);
+        return unique_ptr<Operator>(new JoinOperator(move(left), move(right), leftColumnIndex, rightColumnIndex, query.joinBinaryOperator));
+    }
+    case SORT:
+    {
+        unique_ptr<Operator> input = buildInput(node, query.sortRelationName);
+        if (!input || !isColumnOf(input.get(), query.sortColumnName))
+            return NULL;
+        int columnIndex = input->getColumnIndex(query.sortColumnName);
+        return unique_ptr<Operator>(new SortOperator(move(input), columnIndex, query.sortingStrategy, query.sortLimit));
+    }
+    default:
+        cout << "SEMANTIC ERROR" << endl;
+        return NULL;
+    }
+}
+
+bool semanticParsePIPELINE()
+{
+    logger.log("semanticParsePIPELINE");
+
+    if (tableCatalogue.isTable(parsedQuery.pipelineResultRelationName))
+    {
+        cout << "SEMANTIC ERROR: Resultant relation already exists" << endl;
+        return false;
+    }
+    return buildOperator(parsedQuery.pipelinePlan.get()) != NULL;
+}
+
+/**
+ * @brief Compiles the statement and its nested statements into one operator
+ * tree and drains it into the resultant table. Rows stream from operator to
+ * operator, intermediate results are only written to disk by operators whose
+ * input doesn't fit in memory.
+ */
+void executePIPELINE()
+{
+    logger.log("executePIPELINE");
+
+    unique_ptr<Operator> root = buildOperator(parsedQuery.pipelinePlan.get());
+    Table *resultantTable = new Table(parsedQuery.pipelineResultRelationName, root->columns);
+    PageWriter writer(resultantTable);
+    root->drain(writer);
+    root.reset();
+    if (writer.close())
+        tableCatalogue.insertTable(resultantTable);
+    else
+    {
+        cout << "Empty Table" << endl;
+        resultantTable->unload();
+        delete resultantTable;
+    }
+    return;
+}
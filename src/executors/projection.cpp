@@ -51,27 +51,12 @@ void executePROJECTION()
 {
     logger.log("executePROJECTION");
     Table* resultantTable = new Table(parsedQuery.projectionResultRelationName, parsedQuery.projectionColumnList);
-    Table table = *tableCatalogue.getTable(parsedQuery.projectionRelationName);
-    Cursor cursor = table.getCursor();
-    vector<int> columnIndices;
-    for (int columnCounter = 0; columnCounter < parsedQuery.projectionColumnList.size(); columnCounter++)
-    {
-        columnIndices.emplace_back(table.getColumnIndex(parsedQuery.projectionColumnList[columnCounter]));
-    }
-    vector<int> row = cursor.getNext();
-    vector<int> resultantRow(columnIndices.size(), 0);
-
-    while (!row.empty())
-    {
-
-        for (int columnCounter = 0; columnCounter < columnIndices.size(); columnCounter++)
-        {
-            resultantRow[columnCounter] = row[columnIndices[columnCounter]];
-        }
-        resultantTable->writeRow<int>(resultantRow);
-        row = cursor.getNext();
-    }
-    resultantTable->blockify();
+    Table* table = tableCatalogue.getTable(parsedQuery.projectionRelationName);
+    PageWriter writer(resultantTable);
+    parallelDrain(table, [](unique_ptr<Operator> scan) {
+        return unique_ptr<Operator>(new ProjectOperator(move(scan), parsedQuery.projectionColumnList));
+    }, writer);
+    writer.close();
     tableCatalogue.insertTable(resultantTable);
     return;
-}
\ No newline at end of file
+}
@@ -1,50 +1,72 @@
 #include "global.h"
 /**
  * @brief 
- * SYNTAX: R <- SELECT column_name bin_op [column_name | int_literal] FROM relation_name
+ * SYNTAX: R <- SELECT condition FROM relation_name
+ * condition: comparison [AND | OR comparison]*
+ * comparison: column_name bin_op [column_name | int_literal]
+ * AND binds tighter than OR.
  */
 bool syntacticParseSELECTION()
 {
     logger.log("syntacticParseSELECTION");
-    if (tokenizedQuery.size() != 8 || tokenizedQuery[6] != "FROM")
+    int fromIndex = tokenizedQuery.size() - 2;
+    if (tokenizedQuery.size() < 8 || tokenizedQuery[fromIndex] != "FROM" || (fromIndex - 2) % 4)
     {
         cout << "SYNTAC ERROR" << endl;
         return false;
     }
     parsedQuery.queryType = SELECTION;
     parsedQuery.selectionResultRelationName = tokenizedQuery[0];
-    parsedQuery.selectionFirstColumnName = tokenizedQuery[3];
-    parsedQuery.selectionRelationName = tokenizedQuery[7];
+    parsedQuery.selectionRelationName = tokenizedQuery[fromIndex + 1];
+    parsedQuery.selectionConditions.assign(1, vector<SelectionCondition>());
 
-    string binaryOperator = tokenizedQuery[4];
-    if (binaryOperator == "<")
-        parsedQuery.selectionBinaryOperator = LESS_THAN;
-    else if (binaryOperator == ">")
-        parsedQuery.selectionBinaryOperator = GREATER_THAN;
-    else if (binaryOperator == ">=" || binaryOperator == "=>")
-        parsedQuery.selectionBinaryOperator = GEQ;
-    else if (binaryOperator == "<=" || binaryOperator == "=<")
-        parsedQuery.selectionBinaryOperator = LEQ;
-    else if (binaryOperator == "==")
-        parsedQuery.selectionBinaryOperator = EQUAL;
-    else if (binaryOperator == "!=")
-        parsedQuery.selectionBinaryOperator = NOT_EQUAL;
-    else
-    {
-        cout << "SYNTAC ERROR" << endl;
-        return false;
-    }
     regex numeric("[-]?[0-9]+");
-    string secondArgument = tokenizedQuery[5];
-    if (regex_match(secondArgument, numeric))
+    for (int tokenIndex = 3; tokenIndex < fromIndex; tokenIndex += 4)
     {
-        parsedQuery.selectType = INT_LITERAL;
-        parsedQuery.selectionIntLiteral = stoi(secondArgument);
-    }
-    else
-    {
-        parsedQuery.selectType = COLUMN;
-        parsedQuery.selectionSecondColumnName = secondArgument;
+        if (tokenIndex > 3)
+        {
+            string logicalOperator = tokenizedQuery[tokenIndex - 1];
+            if (logicalOperator == "OR")
+                parsedQuery.selectionConditions.emplace_back();
+            else if (logicalOperator != "AND")
+            {
+                cout << "SYNTAC ERROR" << endl;
+                return false;
+            }
+        }
+
+        SelectionCondition condition;
+        condition.firstColumnName = tokenizedQuery[tokenIndex];
+        string binaryOperator = tokenizedQuery[tokenIndex + 1];
+        if (binaryOperator == "<")
+            condition.binaryOperator = LESS_THAN;
+        else if (binaryOperator == ">")
+            condition.binaryOperator = GREATER_THAN;
+        else if (binaryOperator == ">=" || binaryOperator == "=>")
+            condition.binaryOperator = GEQ;
+        else if (binaryOperator == "<=" || binaryOperator == "=<")
+            condition.binaryOperator = LEQ;
+        else if (binaryOperator == "==")
+            condition.binaryOperator = EQUAL;
+        else if (binaryOperator == "!=")
+            condition.binaryOperator = NOT_EQUAL;
+        else
+        {
+            cout << "SYNTAC ERROR" << endl;
+            return false;
+        }
+        string secondArgument = tokenizedQuery[tokenIndex + 2];
+        if (regex_match(secondArgument, numeric))
+        {
+            condition.selectType = INT_LITERAL;
+            condition.intLiteral = stoi(secondArgument);
+        }
+        else
+        {
+            condition.selectType = COLUMN;
+            condition.secondColumnName = secondArgument;
+        }
+        parsedQuery.selectionConditions.back().emplace_back(condition);
     }
     return true;
 }
@@ -65,18 +87,24 @@ bool semanticParseSELECTION()
         return false;
     }
 
-    if (!tableCatalogue.isColumnFromTable(parsedQuery.selectionFirstColumnName, parsedQuery.selectionRelationName))
+    for (auto &conjunction : parsedQuery.selectionConditions)
     {
-        cout << "SEMANTIC ERROR: Column doesn't exist in relation" << endl;
-        return false;
-    }
-
-    if (parsedQuery.selectType == COLUMN)
-    {
-        if (!tableCatalogue.isColumnFromTable(parsedQuery.selectionSecondColumnName, parsedQuery.selectionRelationName))
+        for (auto &condition : conjunction)
         {
-            cout << "SEMANTIC ERROR: Column doesn't exist in relation" << endl;
-            return false;
+            if (!tableCatalogue.isColumnFromTable(condition.firstColumnName, parsedQuery.selectionRelationName))
+            {
+                cout << "SEMANTIC ERROR: Column doesn't exist in relation" << endl;
+                return false;
+            }
+
+            if (condition.selectType == COLUMN)
+            {
+                if (!tableCatalogue.isColumnFromTable(condition.secondColumnName, parsedQuery.selectionRelationName))
+                {
+                    cout << "SEMANTIC ERROR: Column doesn't exist in relation" << endl;
+                    return false;
+                }
+            }
         }
     }
     return true;
@@ -103,32 +131,128 @@ bool evaluateBinOp(int value1, int value2, BinaryOperator binaryOperator)
     }
 }
 
+/**
+ * @brief Translates a comparison of the indexed column against an integer
+ * literal into the range of values [lowValue, highValue] it accepts.
+ *
+ * @return true if the comparison can be answered by a range search
+ * @return false otherwise (!=)
+ */
+static bool getSearchRange(BinaryOperator binaryOperator, int value, int &lowValue, int &highValue)
+{
+    lowValue = INT_MIN;
+    highValue = INT_MAX;
+    switch (binaryOperator)
+    {
+    case LESS_THAN:
+        if (value == INT_MIN)
+            lowValue = INT_MAX;
+        highValue = value - (value != INT_MIN);
+        return true;
+    case GREATER_THAN:
+        if (value == INT_MAX)
+            highValue = INT_MIN;
+        lowValue = value + (value != INT_MAX);
+        return true;
+    case LEQ:
+        highValue = value;
+        return true;
+    case GEQ:
+        lowValue = value;
+        return true;
+    case EQUAL:
+        lowValue = highValue = value;
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief Finds a comparison of the indexed column of table against a literal
+ * that its index can answer, and the range of values it accepts. Only
+ * conditions without OR qualify.
+ *
+ * @param table
+ * @param conjunctions condition bound to the columns of table
+ * @param lowValue
+ * @param highValue
+ * @return int position of the comparison in its AND-group, -1 if there is none
+ */
+int findIndexedCondition(Table *table, const vector<vector<BoundCondition>> &conjunctions, int &lowValue, int &highValue)
+{
+    if (conjunctions.size() != 1 || !table->indexed || !table->index)
+        return -1;
+    int indexedColumnIndex = table->getColumnIndex(table->indexedColumn);
+    const vector<BoundCondition> &conjunction = conjunctions.front();
+    for (int conditionCounter = 0; conditionCounter < conjunction.size(); conditionCounter++)
+    {
+        const BoundCondition &condition = conjunction[conditionCounter];
+        if (condition.secondColumnIndex >= 0 || condition.firstColumnIndex != indexedColumnIndex)
+            continue;
+        if (!getSearchRange(condition.binaryOperator, condition.intLiteral, lowValue, highValue))
+            continue;
+        if (lowValue != highValue && !table->index->supportsRangeSearch())
+            continue;
+        return conditionCounter;
+    }
+    return -1;
+}
+
+/**
+ * @brief Answers the selection using the index of the table, reading only the
+ * pages holding rows that match the comparison found by findIndexedCondition.
+ * The remaining comparisons of its AND-group are checked on the fetched rows.
+ */
+static void indexSelection(Table *table, vector<vector<BoundCondition>> &conjunctions)
+{
+    logger.log("indexSelection");
+    int lowValue, highValue;
+    int searchedCondition = findIndexedCondition(table, conjunctions, lowValue, highValue);
+    vector<BoundCondition> &conjunction = conjunctions.front();
+
+    Table *resultantTable = new Table(parsedQuery.selectionResultRelationName, table->columns);
+    PageWriter writer(resultantTable);
+    for (auto &row : table->getRows(table->index->search(lowValue, highValue)))
+    {
+        bool matches = true;
+        for (int conditionCounter = 0; conditionCounter < conjunction.size() && matches; conditionCounter++)
+        {
+            BoundCondition &condition = conjunction[conditionCounter];
+            if (conditionCounter != searchedCondition)
+                matches = evaluateBinOp(row[condition.firstColumnIndex], condition.secondColumnIndex >= 0 ? row[condition.secondColumnIndex] : condition.intLiteral, condition.binaryOperator);
+        }
+        if (matches)
+            writer.writeRow(row);
+    }
+    if (writer.close())
+        tableCatalogue.insertTable(resultantTable);
+    else
+    {
+        cout << "Empty Table" << endl;
+        resultantTable->unload();
+        delete resultantTable;
+    }
+}
+
 void executeSELECTION()
 {
     logger.log("executeSELECTION");
 
-    Table table = *tableCatalogue.getTable(parsedQuery.selectionRelationName);
-    Table* resultantTable = new Table(parsedQuery.selectionResultRelationName, table.columns);
-    Cursor cursor = table.getCursor();
-    vector<int> row = cursor.getNext();
-    int firstColumnIndex = table.getColumnIndex(parsedQuery.selectionFirstColumnName);
-    int secondColumnIndex;
-    if (parsedQuery.selectType == COLUMN)
-        secondColumnIndex = table.getColumnIndex(parsedQuery.selectionSecondColumnName);
-    while (!row.empty())
+    Table *table = tableCatalogue.getTable(parsedQuery.selectionRelationName);
+    vector<vector<BoundCondition>> conjunctions = bindConditions(parsedQuery.selectionConditions, table->columns, table->distinctValuesPerColumnCount);
+    if (planSelection(table, conjunctions).physicalOperator == INDEX_SCAN)
     {
-
-        int value1 = row[firstColumnIndex];
-        int value2;
-        if (parsedQuery.selectType == INT_LITERAL)
-            value2 = parsedQuery.selectionIntLiteral;
-        else
-            value2 = row[secondColumnIndex];
-        if (evaluateBinOp(value1, value2, parsedQuery.selectionBinaryOperator))
-            resultantTable->writeRow<int>(row);
-        row = cursor.getNext();
+        indexSelection(table, conjunctions);
+        return;
     }
-    if(resultantTable->blockify())
+
+    Table* resultantTable = new Table(parsedQuery.selectionResultRelationName, table->columns);
+    PageWriter writer(resultantTable);
+    parallelDrain(table, [](unique_ptr<Operator> scan) {
+        return unique_ptr<Operator>(new FilterOperator(move(scan), parsedQuery.selectionConditions));
+    }, writer);
+    if(writer.close())
         tableCatalogue.insertTable(resultantTable);
     else{
         cout<<"Empty Table"<<endl;
@@ -136,4 +260,4 @@ void executeSELECTION()
         delete resultantTable;
     }
     return;
-}
\ No newline at end of file
+}
@@ -3,13 +3,13 @@
  * @brief File contains method to process SORT commands.
  * 
  * syntax:
- * R <- SORT relation_name BY column_name IN sorting_order
+ * R <- SORT relation_name BY column_name IN sorting_order [LIMIT k]
  * 
  * sorting_order = ASC | DESC 
  */
 bool syntacticParseSORT(){
     logger.log("syntacticParseSORT");
-    if(tokenizedQuery.size()!= 8 || tokenizedQuery[4] != "BY" || tokenizedQuery[6] != "IN"){
+    if((tokenizedQuery.size()!= 8 && tokenizedQuery.size() != 10) || tokenizedQuery[4] != "BY" || tokenizedQuery[6] != "IN"){
         cout<<"SYNTAX ERROR"<<endl;
         return false;
     }
@@ -26,6 +26,18 @@ bool syntacticParseSORT(){
         cout<<"SYNTAX ERROR"<<endl;
         return false;
     }
+    if(tokenizedQuery.size() == 10){
+        regex numeric("[0-9]+");
+        if(tokenizedQuery[8] != "LIMIT" || !regex_match(tokenizedQuery[9], numeric)){
+            cout<<"SYNTAX ERROR"<<endl;
+            return false;
+        }
+        //A limit past INT_MAX keeps every row, so it is clamped rather than overflowing
+        long long sortLimit = 0;
+        for(char digit : tokenizedQuery[9])
+            sortLimit = min(sortLimit * 10 + (digit - '0'), (long long)INT_MAX);
+        parsedQuery.sortLimit = sortLimit;
+    }
     return true;
 }
 
@@ -47,10 +59,239 @@ bool semanticParseSORT(){
         return false;
     }
 
+    if(parsedQuery.sortLimit == 0){
+        cout<<"SEMANTIC ERROR: LIMIT should be positive"<<endl;
+        return false;
+    }
+
     return true;
 }
 
+/**
+ * @brief Orders rows on the sort columns. Ties are broken on the sequence
+ * number that travels with each row (the position of the row in its input or
+ * the run it was read from) which keeps every sort in this file stable.
+ */
+class RowComparator{
+    vector<int> columnIndices;
+    SortingStrategy sortingStrategy;
+
+    public:
+    RowComparator(vector<int> columnIndices, SortingStrategy sortingStrategy){
+        this->columnIndices = columnIndices;
+        this->sortingStrategy = sortingStrategy;
+    }
+
+    bool operator()(const pair<vector<int>, long long> &a, const pair<vector<int>, long long> &b) const {
+        for(int columnIndex : this->columnIndices){
+            if(a.first[columnIndex] != b.first[columnIndex]){
+                if(this->sortingStrategy == DESC)
+                    return a.first[columnIndex] > b.first[columnIndex];
+                return a.first[columnIndex] < b.first[columnIndex];
+            }
+        }
+        return a.second < b.second;
+    }
+};
+
+/**
+ * @brief Sorts rows on the thread pool. Slices of the rows are sorted by
+ * separate tasks and then merged pairwise, the merges of every round running
+ * as tasks as well. Inputs too small to be worth splitting are sorted
+ * directly.
+ */
+static void parallelSort(vector<pair<vector<int>, long long>> &rows, const RowComparator &comparator){
+    const long long MIN_SLICE_ROW_COUNT = 1024;
+    int sliceCount = min((long long)WORKER_COUNT, (long long)rows.size() / MIN_SLICE_ROW_COUNT);
+    if(sliceCount <= 1){
+        sort(rows.begin(), rows.end(), comparator);
+        return;
+    }
+
+    vector<long long> bounds(sliceCount + 1);
+    for(int sliceCounter = 0; sliceCounter <= sliceCount; sliceCounter++)
+        bounds[sliceCounter] = rows.size() * sliceCounter / sliceCount;
+    TaskGroup sorts;
+    for(int sliceCounter = 0; sliceCounter < sliceCount; sliceCounter++)
+        sorts.submit([&, sliceCounter](){ sort(rows.begin() + bounds[sliceCounter], rows.begin() + bounds[sliceCounter + 1], comparator); });
+    sorts.wait();
+    for(int width = 1; width < sliceCount; width *= 2){
+        TaskGroup merges;
+        for(int sliceCounter = 0; sliceCounter + width < sliceCount; sliceCounter += 2 * width)
+            merges.submit([&, sliceCounter, width](){
+                inplace_merge(rows.begin() + bounds[sliceCounter], rows.begin() + bounds[sliceCounter + width], rows.begin() + bounds[min(sliceCounter + 2 * width, sliceCount)], comparator);
+            });
+        merges.wait();
+    }
+}
+
+/**
+ * @brief Creates an empty table that takes over the columns of table. Sort runs
+ * are stored as temporary tables so that they can be read back using cursors.
+ */
+static Table* createRun(Table* table, string runName){
+    Table* run = new Table(runName, table->columns);
+    tableCatalogue.insertTable(run);
+    return run;
+}
+
+/**
+ * @brief Phase one of the two phase merge sort. The table is read
+ * MEMORY_BLOCK_COUNT blocks at a time, every chunk is sorted in main memory (in
+ * parallel) and written out as a sorted run. If the whole table fits in a single chunk the
+ * run is written straight into the resultant table.
+ *
+ * @return vector<Table*> the sorted runs 
+ */
+static vector<Table*> createSortedRuns(Table* table, string resultRelationName, RowComparator comparator, int limit){
+    logger.log("createSortedRuns");
+    vector<Table*> runs;
+    long long rowsPerRun = (long long)MEMORY_BLOCK_COUNT * table->maxRowsPerBlock;
+    bool singleRun = table->rowCount <= rowsPerRun;
+    vector<pair<vector<int>, long long>> rowsInRun;
+    rowsInRun.reserve(min(rowsPerRun, table->rowCount));
+
+    Cursor cursor = table->getCursor();
+    RowBatch batch;
+    long long rowCounter = 0;
+    do{
+        batch = cursor.getNextBatch(rowsPerRun - rowsInRun.size());
+        for(auto &row : batch)
+            rowsInRun.emplace_back(row, rowCounter++);
+        if(!rowsInRun.empty() && (rowsInRun.size() == rowsPerRun || batch.empty())){
+            parallelSort(rowsInRun, comparator);
+            //Only the first limit rows of a run can make it to the result
+            if(limit >= 0 && rowsInRun.size() > limit)
+                rowsInRun.resize(limit);
+            string runName = singleRun ? resultRelationName : tableCatalogue.getTempTableName(resultRelationName + "_Run");
+            Table* run = createRun(table, runName);
+            PageWriter writer(run);
+            for(auto &sortedRow : rowsInRun)
+                writer.writeRow(sortedRow.first);
+            writer.close();
+            runs.emplace_back(run);
+            rowsInRun.clear();
+        }
+    }while(!batch.empty());
+    return runs;
+}
+
+/**
+ * @brief Merges the given sorted runs into run using a heap. On ties the row of
+ * the earlier run wins, which is what keeps the merge stable.
+ */
+static void mergeRuns(vector<Table*> &runs, Table* run, RowComparator comparator, int limit){
+    logger.log("mergeRuns");
+    vector<Cursor> cursors;
+    priority_queue<pair<vector<int>, long long>, vector<pair<vector<int>, long long>>, function<bool(const pair<vector<int>, long long>&, const pair<vector<int>, long long>&)>> heap(
+        [&comparator](const pair<vector<int>, long long> &a, const pair<vector<int>, long long> &b){ return comparator(b, a); });
+    for(int runCounter = 0; runCounter < runs.size(); runCounter++){
+        cursors.emplace_back(runs[runCounter]->getCursor());
+        heap.emplace(cursors.back().getNext(), runCounter);
+    }
+
+    PageWriter writer(run);
+    long long rowCounter = 0;
+    while(!heap.empty() && (limit < 0 || rowCounter < limit)){
+        pair<vector<int>, long long> top = heap.top();
+        heap.pop();
+        writer.writeRow(top.first);
+        rowCounter++;
+        vector<int> row = cursors[top.second].getNext();
+        if(!row.empty())
+            heap.emplace(row, top.second);
+    }
+    writer.close();
+}
+
+/**
+ * @brief Sorts table on the columns in columnIndices using a two phase
+ * (external) merge sort that never holds more than MEMORY_BLOCK_COUNT blocks
+ * of rows in memory. Runs are merged MEMORY_BLOCK_COUNT - 1 at a time until a
+ * single run is left, which becomes the resultant table. If limit is not
+ * negative only the first limit rows of the sorted order are kept.
+ *
+ * The resultant table is inserted into the table catalogue.
+ *
+ * @param table 
+ * @param resultRelationName 
+ * @param columnIndices 
+ * @param sortingStrategy 
+ * @param limit 
+ * @return Table* 
+ */
+Table* sortTable(Table* table, string resultRelationName, vector<int> columnIndices, SortingStrategy sortingStrategy, int limit){
+    logger.log("sortTable");
+    RowComparator comparator(columnIndices, sortingStrategy);
+    vector<Table*> runs = createSortedRuns(table, resultRelationName, comparator, limit);
+    int mergeDegree = max((int)MEMORY_BLOCK_COUNT - 1, 2);
+
+    while(runs.size() > 1){
+        vector<Table*> mergedRuns;
+        bool lastPass = runs.size() <= mergeDegree;
+        for(int runCounter = 0; runCounter < runs.size(); runCounter += mergeDegree){
+            vector<Table*> runsToMerge(runs.begin() + runCounter, runs.begin() + min((int)runs.size(), runCounter + mergeDegree));
+            string runName = lastPass ? resultRelationName : tableCatalogue.getTempTableName(resultRelationName + "_Run");
+            Table* run = createRun(table, runName);
+            mergeRuns(runsToMerge, run, comparator, limit);
+            for(Table* mergedRun : runsToMerge)
+                tableCatalogue.deleteTable(mergedRun->tableName);
+            mergedRuns.emplace_back(run);
+        }
+        runs = mergedRuns;
+    }
+    return runs.front();
+}
+
+/**
+ * @brief Keeps the first limit rows of the sorted order in a bounded heap while
+ * streaming over the table once. The heap's top is the worst row kept so far,
+ * every incoming row only has to be compared against it.
+ */
+static void topKSort(Table* table, Table* resultantTable, RowComparator comparator, int limit){
+    logger.log("topKSort");
+    priority_queue<pair<vector<int>, long long>, vector<pair<vector<int>, long long>>, RowComparator> heap(comparator);
+
+    Cursor cursor = table->getCursor();
+    long long rowCounter = 0;
+    for(RowBatch batch = cursor.getNextBatch(); !batch.empty(); batch = cursor.getNextBatch()){
+        for(auto &row : batch){
+            pair<vector<int>, long long> current(row, rowCounter++);
+            if(heap.size() < limit)
+                heap.push(current);
+            else if(comparator(current, heap.top())){
+                heap.pop();
+                heap.push(current);
+            }
+        }
+    }
+
+    vector<vector<int>> sortedRows(heap.size());
+    for(int rowCounter = sortedRows.size() - 1; rowCounter >= 0; rowCounter--){
+        sortedRows[rowCounter] = heap.top().first;
+        heap.pop();
+    }
+    PageWriter writer(resultantTable);
+    for(auto &sortedRow : sortedRows)
+        writer.writeRow(sortedRow);
+    writer.close();
+}
+
 void executeSORT(){
     logger.log("executeSORT");
+    Table* table = tableCatalogue.getTable(parsedQuery.sortRelationName);
+    vector<int> columnIndices = {table->getColumnIndex(parsedQuery.sortColumnName)};
+
+    //A LIMIT whose rows fit in memory (leaving a block for the input page) is
+    //answered by a single scan without writing any runs
+    Table* resultantTable;
+    if(planSort(table, parsedQuery.sortLimit).physicalOperator == TOP_K_SORT){
+        resultantTable = new Table(parsedQuery.sortResultRelationName, table->columns);
+        topKSort(table, resultantTable, RowComparator(columnIndices, parsedQuery.sortingStrategy), parsedQuery.sortLimit);
+        tableCatalogue.insertTable(resultantTable);
+    }
+    else
+        resultantTable = sortTable(table, parsedQuery.sortResultRelationName, columnIndices, parsedQuery.sortingStrategy, parsedQuery.sortLimit);
+    resultantTable->sortedColumn = parsedQuery.sortColumnName;
     return;
-}
\ No newline at end of file
+}
@@ -27,8 +27,102 @@ bool semanticParseSOURCE()
     return true;
 }
 
+/**
+ * @brief Counts the statements after statementIndex that refer to
+ * relationName, apart from "CLEAR relationName".
+ */
+static int countUses(const vector<vector<string>> &statements, int statementIndex, string relationName)
+{
+    int useCount = 0;
+    for (int statementCounter = statementIndex + 1; statementCounter < statements.size(); statementCounter++)
+    {
+        const vector<string> &statement = statements[statementCounter];
+        if (statement.size() == 2 && statement[0] == "CLEAR")
+            continue;
+        useCount += count(statement.begin(), statement.end(), relationName);
+    }
+    return useCount;
+}
+
+/**
+ * @brief Fuses "X <- CROSS A B" followed by "Y <- SELECT condition FROM X" into
+ * "Y <- SELECT condition FROM (CROSS A B)" when X isn't used by any later
+ * statement other than "CLEAR X", which is dropped. The selection then reaches
+ * the planner together with the cross product it filters, which rewrites the
+ * pair into a join instead of materializing the cross product.
+ *
+ * @param statements tokenized statements of the script
+ */
+static void fuseCrossSelections(vector<vector<string>> &statements)
+{
+    logger.log("fuseCrossSelections");
+    for (int statementCounter = 0; statementCounter + 1 < statements.size(); statementCounter++)
+    {
+        vector<string> &cross = statements[statementCounter];
+        vector<string> &selection = statements[statementCounter + 1];
+        if (cross.size() < 5 || cross[1] != "<-" || cross[2] != "CROSS")
+            continue;
+        string crossResultRelationName = cross[0];
+        if (selection.size() < 8 || selection[1] != "<-" || selection[2] != "SELECT" || selection.back() != crossResultRelationName || selection[selection.size() - 2] != "FROM")
+            continue;
+        if (count(selection.begin(), selection.end(), crossResultRelationName) != 1 || countUses(statements, statementCounter + 1, crossResultRelationName))
+            continue;
+
+        selection.pop_back();
+        selection.push_back("(");
+        selection.insert(selection.end(), cross.begin() + 2, cross.end());
+        selection.push_back(")");
+        statements.erase(statements.begin() + statementCounter);
+        for (int statementCounter2 = statementCounter + 1; statementCounter2 < statements.size(); statementCounter2++)
+        {
+            if (statements[statementCounter2] == vector<string>{"CLEAR", crossResultRelationName})
+            {
+                statements.erase(statements.begin() + statementCounter2);
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Runs the statements of "../data/<filename>.ra" one after the other, as
+ * if they were typed at the prompt. The whole script is read before anything
+ * runs so statements can be rewritten knowing what follows them. A QUIT ends
+ * the script, not the server.
+ */
 void executeSOURCE()
 {
     logger.log("executeSOURCE");
+
+    ifstream fin("../data/" + parsedQuery.sourceFileName + ".ra", ios::in);
+    vector<vector<string>> statements;
+    string line;
+    while (getline(fin, line))
+    {
+        vector<string> tokens = tokenizeCommand(line);
+        if (!tokens.empty())
+            statements.push_back(tokens);
+    }
+    fin.close();
+    fuseCrossSelections(statements);
+
+    for (auto &statement : statements)
+    {
+        if (statement.size() == 1 && statement.front() == "QUIT")
+            break;
+        cout << "\n> ";
+        for (int tokenCounter = 0; tokenCounter < statement.size(); tokenCounter++)
+            cout << (tokenCounter ? " " : "") << statement[tokenCounter];
+        cout << endl;
+        if (statement.size() == 1)
+        {
+            cout << "SYNTAX ERROR" << endl;
+            continue;
+        }
+        tokenizedQuery = statement;
+        parsedQuery.clear();
+        if (syntacticParse() && semanticParse())
+            executeCommand();
+    }
     return;
 }
@@ -2,6 +2,9 @@
 
 extern float BLOCK_SIZE;
 extern uint BLOCK_COUNT;
+extern uint MEMORY_BLOCK_COUNT;
+extern uint WORKER_COUNT;
+extern bool PIN_WORKER_THREADS;
 extern uint PRINT_COUNT;
 extern vector<string> tokenizedQuery;
 extern ParsedQuery parsedQuery;
@@ -0,0 +1,262 @@
+#include "global.h"
+
+/**
+ * @brief Construct a new HashIndex object holding a single empty bucket.
+ * Bucket pages are stored as "<indexName>_IndexPage<pageIndex>".
+ *
+ * @param indexName
+ */
+HashIndex::HashIndex(string indexName)
+{
+    logger.log("HashIndex::HashIndex");
+    this->indexName = indexName;
+    //One row of every bucket page is taken by the header
+    this->maxEntriesPerBucket = (uint)((BLOCK_SIZE * 1000) / (sizeof(int) * 3)) - 1;
+    this->directory.push_back(this->createBucket(0));
+    vector<vector<int>> entries;
+    this->writeBucket(this->directory[0], entries);
+}
+
+/**
+ * @brief Hash of a value, the directory is indexed by its low bits.
+ *
+ * @param value
+ * @return uint
+ */
+uint HashIndex::hashValue(int value)
+{
+    uint hash = (uint)value * 0x9E3779B1u;
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6Bu;
+    hash ^= hash >> 13;
+    return hash;
+}
+
+/**
+ * @brief Allocates the page of a new bucket.
+ *
+ * @param localDepth
+ * @return int page index of the bucket
+ */
+int HashIndex::createBucket(int localDepth)
+{
+    this->localDepths.resize(this->pageCount + 1, -1);
+    this->overflowPages.resize(this->pageCount + 1);
+    this->bucketEntryCounts.resize(this->pageCount + 1, 0);
+    this->localDepths[this->pageCount] = localDepth;
+    return this->pageCount++;
+}
+
+/**
+ * @brief Reads all entries of a bucket, following its overflow pages.
+ *
+ * @param pageIndex
+ * @return vector<vector<int>>
+ */
+vector<vector<int>> HashIndex::readBucket(int pageIndex)
+{
+    logger.log("HashIndex::readBucket");
+    vector<vector<int>> entries;
+    while (pageIndex != -1)
+    {
+        IndexPage *page = bufferManager.getIndexPage(this->indexName, pageIndex);
+        entries.insert(entries.end(), page->rows.begin() + 1, page->rows.begin() + page->rowCount);
+        pageIndex = page->rows[0][2];
+    }
+    return entries;
+}
+
+/**
+ * @brief Writes entries as the contents of a bucket. Entries that don't fit in
+ * the bucket page go to its overflow pages, which are allocated as needed and
+ * reused when the bucket is written again.
+ *
+ * @param pageIndex
+ * @param entries
+ */
+void HashIndex::writeBucket(int pageIndex, vector<vector<int>> &entries)
+{
+    logger.log("HashIndex::writeBucket");
+    int pagesNeeded = max((int)((entries.size() + this->maxEntriesPerBucket - 1) / this->maxEntriesPerBucket), 1);
+    vector<int> &overflowPages = this->overflowPages[pageIndex];
+    while (overflowPages.size() < pagesNeeded - 1)
+        overflowPages.push_back(this->pageCount++);
+    this->bucketEntryCounts[pageIndex] = entries.size();
+
+    int entryCounter = 0;
+    for (int pageCounter = 0; pageCounter < pagesNeeded; pageCounter++)
+    {
+        int entryCount = min((int)entries.size() - entryCounter, (int)this->maxEntriesPerBucket);
+        int nextPageIndex = pageCounter + 1 < pagesNeeded ? overflowPages[pageCounter] : -1;
+        vector<vector<int>> rows;
+        rows.reserve(entryCount + 1);
+        rows.push_back({this->localDepths[pageIndex], entryCount, nextPageIndex});
+        rows.insert(rows.end(), entries.begin() + entryCounter, entries.begin() + entryCounter + entryCount);
+        entryCounter += entryCount;
+        bufferManager.writeIndexPage(this->indexName, pageCounter ? overflowPages[pageCounter - 1] : pageIndex, rows, rows.size());
+    }
+}
+
+/**
+ * @brief Stores entries, the complete contents of a bucket after an insertion,
+ * in the bucket. As long as they don't fit in a single page and don't all share
+ * one value, the bucket is split on the next bit of the hash.
+ *
+ * @param pageIndex
+ * @param entries
+ */
+void HashIndex::insertIntoBucket(int pageIndex, vector<vector<int>> &entries)
+{
+    logger.log("HashIndex::insertIntoBucket");
+    const int MAX_DEPTH = 24;
+    int localDepth = this->localDepths[pageIndex];
+    bool splittable = entries.size() > this->maxEntriesPerBucket && localDepth < MAX_DEPTH;
+    if (splittable)
+    {
+        splittable = false;
+        for (auto &entry : entries)
+            if (entry[0] != entries.front()[0])
+            {
+                splittable = true;
+                break;
+            }
+    }
+    if (!splittable)
+    {
+        this->writeBucket(pageIndex, entries);
+        return;
+    }
+
+    if (localDepth == this->globalDepth)
+    {
+        int slotCount = this->directory.size();
+        this->directory.resize(2 * slotCount);
+        copy_n(this->directory.begin(), slotCount, this->directory.begin() + slotCount);
+        this->globalDepth++;
+    }
+    this->localDepths[pageIndex] = localDepth + 1;
+    int newPageIndex = this->createBucket(localDepth + 1);
+    for (int slot = 0; slot < this->directory.size(); slot++)
+        if (this->directory[slot] == pageIndex && ((slot >> localDepth) & 1))
+            this->directory[slot] = newPageIndex;
+
+    vector<vector<int>> keptEntries, movedEntries;
+    for (auto &entry : entries)
+    {
+        if ((this->hashValue(entry[0]) >> localDepth) & 1)
+            movedEntries.emplace_back(entry);
+        else
+            keptEntries.emplace_back(entry);
+    }
+    this->insertIntoBucket(pageIndex, keptEntries);
+    this->insertIntoBucket(newPageIndex, movedEntries);
+}
+
+/**
+ * @brief Inserts (value, pageIndex, pagePointer) entries into the index.
+ * Entries are grouped by bucket so every affected bucket is read and written
+ * once per call, splitting it as often as needed.
+ *
+ * @param entries
+ */
+void HashIndex::insert(vector<vector<int>> &entries)
+{
+    logger.log("HashIndex::insert");
+    map<int, vector<vector<int>>> entriesPerBucket;
+    for (auto &entry : entries)
+        entriesPerBucket[this->directory[this->hashValue(entry[0]) & ((1u << this->globalDepth) - 1)]].emplace_back(entry);
+
+    for (auto &bucket : entriesPerBucket)
+    {
+        vector<vector<int>> bucketEntries = this->readBucket(bucket.first);
+        bucketEntries.insert(bucketEntries.end(), bucket.second.begin(), bucket.second.end());
+        this->insertIntoBucket(bucket.first, bucketEntries);
+    }
+}
+
+/**
+ * @brief Inserts the entries of all rows of the table, MEMORY_BLOCK_COUNT
+ * blocks of rows at a time.
+ *
+ * @param table
+ * @param columnIndex
+ */
+void HashIndex::build(Table *table, int columnIndex)
+{
+    logger.log("HashIndex::build");
+    vector<vector<int>> entries;
+    for (int pageIndex = 0; pageIndex < table->blockCount; pageIndex++)
+    {
+        TablePage page = bufferManager.getPage(table->tableName, pageIndex);
+        for (int pagePointer = 0; pagePointer < page.rowCount; pagePointer++)
+            entries.push_back({page.rows[pagePointer][columnIndex], pageIndex, pagePointer});
+        if ((pageIndex + 1) % MEMORY_BLOCK_COUNT == 0 || pageIndex == table->blockCount - 1)
+        {
+            this->insert(entries);
+            entries.clear();
+        }
+    }
+}
+
+/**
+ * @brief Returns the locations of the rows holding lowValue. The hash index
+ * only answers point searches, so lowValue is expected to equal highValue.
+ *
+ * @param lowValue
+ * @param highValue
+ * @return vector<pair<int, int>>
+ */
+vector<pair<int, int>> HashIndex::search(int lowValue, int highValue)
+{
+    logger.log("HashIndex::search");
+    vector<pair<int, int>> rowLocations;
+    if (lowValue != highValue)
+        return rowLocations;
+    int pageIndex = this->directory[this->hashValue(lowValue) & ((1u << this->globalDepth) - 1)];
+    for (auto &entry : this->readBucket(pageIndex))
+        if (entry[0] == lowValue)
+            rowLocations.emplace_back(entry[1], entry[2]);
+    return rowLocations;
+}
+
+bool HashIndex::supportsRangeSearch()
+{
+    return false;
+}
+
+/**
+ * @brief A search reads the bucket page of the value and the overflow pages
+ * chained to it. The chain length is averaged over the indexed rows rather
+ * than the buckets, as values that overflow a bucket are the ones searched
+ * for most often, e.g. by an index nested loop join.
+ *
+ * @return int
+ */
+int HashIndex::getSearchCost()
+{
+    long long entryCount = 0, chainedEntryCount = 0;
+    for (int pageIndex = 0; pageIndex < this->localDepths.size(); pageIndex++)
+    {
+        if (this->localDepths[pageIndex] < 0)
+            continue;
+        long long bucketEntryCount = this->bucketEntryCounts[pageIndex];
+        long long chainLength = max((bucketEntryCount + this->maxEntriesPerBucket - 1) / this->maxEntriesPerBucket, 1LL);
+        entryCount += bucketEntryCount;
+        chainedEntryCount += bucketEntryCount * chainLength;
+    }
+    if (!entryCount)
+        return 1;
+    return max((int)round((double)chainedEntryCount / entryCount), 1);
+}
+
+/**
+ * @brief Deletes all bucket pages of the index.
+ *
+ */
+void HashIndex::unload()
+{
+    logger.log("HashIndex::unload");
+    for (int pageCounter = 0; pageCounter < this->pageCount; pageCounter++)
+        bufferManager.deleteFile("../data/temp/" + this->indexName + "_IndexPage" + to_string(pageCounter));
+    this->pageCount = 0;
+}
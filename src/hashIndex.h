@@ -0,0 +1,44 @@
+#include "bPlusTree.h"
+
+/**
+ * @brief The HashIndex is a disk resident extendible hash index on a column of
+ * a table, created using INDEX ... USING HASH. Buckets are index pages read
+ * and written through the buffer manager, each starting with the header row
+ * (localDepth, entryCount, overflowPageIndex) followed by entryCount entries
+ * (value, pageIndex, pagePointer).
+ *
+ * <p>
+ * The directory maps the low globalDepth bits of a value's hash to a bucket and
+ * is small enough to be kept in memory. A bucket that overflows is split on
+ * the next bit of the hash, doubling the directory when its local depth
+ * catches up with the global depth. A bucket whose entries all share one value
+ * cannot be split and is chained to overflow pages instead.
+ * </p>
+ *
+ */
+class HashIndex : public TableIndex
+{
+    string indexName;
+    int globalDepth = 0;
+    vector<int> directory;
+    vector<int> localDepths;
+    vector<vector<int>> overflowPages;
+    vector<int> bucketEntryCounts;
+    uint pageCount = 0;
+    uint maxEntriesPerBucket = 0;
+
+    uint hashValue(int value);
+    int createBucket(int localDepth);
+    vector<vector<int>> readBucket(int pageIndex);
+    void writeBucket(int pageIndex, vector<vector<int>> &entries);
+    void insertIntoBucket(int pageIndex, vector<vector<int>> &entries);
+
+public:
+    HashIndex(string indexName);
+    void build(Table *table, int columnIndex);
+    void insert(vector<vector<int>> &entries);
+    vector<pair<int, int>> search(int lowValue, int highValue);
+    bool supportsRangeSearch();
+    int getSearchCost();
+    void unload();
+};
@@ -9,5 +9,8 @@ Logger::Logger()
 void Logger::log(string logString)
 {
     if (this->TO_LOG)
+    {
+        lock_guard<mutex> lock(this->logMutex);
         fout << logString << endl;
+    }
 }
@@ -14,6 +14,7 @@ class Logger
 
     string logFile = "log";
     ofstream fout;
+    mutex logMutex;
 
 public:
     Logger();
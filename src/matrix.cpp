@@ -67,7 +67,7 @@ bool Matrix::slowBlockify()
             if (rowCounter == this->maxRowsPerBlock)
             {
                 int blockNum = block_i * this->blocksPerRow + block_j;
-                bufferManager.writeMatrixPage(this->matrixName, blockNum, rows, rowCounter);
+                this->blockEncodings[blockNum] = bufferManager.writeMatrixPage(this->matrixName, blockNum, rows, rowCounter);
                 block_i++;
                 this->dimPerBlockCount[blockNum] = {rowCounter, columnsInBlock};
                 rowCounter = 0;
@@ -77,7 +77,7 @@ bool Matrix::slowBlockify()
         if (rowCounter)
         {
             int blockNum = block_i * this->blocksPerRow + block_j;
-            bufferManager.writeMatrixPage(this->matrixName, blockNum, rows, rowCounter);
+            this->blockEncodings[blockNum] = bufferManager.writeMatrixPage(this->matrixName, blockNum, rows, rowCounter);
             block_i++;
             this->dimPerBlockCount[blockNum] = {rowCounter, columnsInBlock};
             rowCounter = 0;
@@ -136,15 +136,7 @@ bool Matrix::blockify()
     if (!this->setStatistics())
         return false;
 
-    if (this->isSparseMatrix)
-    {
-        this->sparseBlockify();
-    }
-
-    else
-    {
-        this->normalBlockify();
-    }
+    this->normalBlockify();
 
     if (this->rowCount == 0)
         return false;
@@ -152,10 +144,18 @@ bool Matrix::blockify()
     return true;
 }
 
+/**
+ * @brief Streams the matrix into its tiles row segment by row segment,
+ * counting the nonzero values of every tile. Tiles are written dense; those
+ * that take less space compressed or that hold zeros only are then read back
+ * one at a time and rewritten in their encoding.
+ *
+ */
 void Matrix::normalBlockify()
 {
     logger.log("Matrix::normalBlockify");
     ifstream fin(this->sourceFileName, ios::in);
+    vector<long long> nonzeroCounts(this->blockCount, 0);
 
     for (int row = 0; row < this->rowCount; row++)
     {
@@ -171,6 +171,7 @@ void Matrix::normalBlockify()
             vector<int> rowSegment = this->readRowSegment(numOfWords, fin, block == (this->blocksPerRow - 1));
             int pageIndex = (row / this->maxRowsPerBlock) * this->blocksPerRow + block;
             this->writeRowSegment(rowSegment, pageIndex);
+            nonzeroCounts[pageIndex] += count_if(rowSegment.begin(), rowSegment.end(), [](int value) { return value != 0; });
 
             this->dimPerBlockCount[pageIndex].first++;
             if (this->dimPerBlockCount[pageIndex].second == 0)
@@ -181,73 +182,21 @@ void Matrix::normalBlockify()
     }
 
     fin.close();
-}
 
-void Matrix::sparseBlockify()
-{
-    logger.log("Matrix::sparseBlockify");
-    ifstream fin(this->sourceFileName, ios::in);
-
-    string word;
-
-    int numAttributes = 3;
-    vector<int> row(numAttributes, 0);
-    vector<vector<int>> rowsInPage(this->maxRowsPerBlock, row);
-    int pageCounter = 0;
-    int curPageIndex = 0;
-
-    for (int i = 0; i < this->columnCount * this->columnCount; i++)
+    for (int pageIndex = 0; pageIndex < this->blockCount; pageIndex++)
     {
-        if ((i + 1) % this->columnCount != 0)
+        TileEncoding encoding = MatrixPage::getEncoding(this->dimPerBlockCount[pageIndex].first, this->dimPerBlockCount[pageIndex].second, nonzeroCounts[pageIndex]);
+        if (encoding == ZERO_TILE)
         {
-            if (getline(fin, word, ','))
-            {
-                word.erase(remove_if(word.begin(), word.end(), ::isspace), word.end());
-
-                if (stoi(word) != 0)
-                {
-                    rowsInPage[pageCounter][0] = i / this->columnCount;
-                    rowsInPage[pageCounter][1] = i % this->columnCount;
-                    rowsInPage[pageCounter][2] = stoi(word);
-                    pageCounter++;
-                }
-            }
+            bufferManager.deleteFile(this->matrixName, pageIndex);
+            this->blockEncodings[pageIndex] = ZERO_TILE;
         }
-
-        else
+        else if (encoding == SPARSE_TILE)
         {
-            if (getline(fin, word, '\n'))
-            {
-                word.erase(remove_if(word.begin(), word.end(), ::isspace), word.end());
-
-                if (stoi(word) != 0)
-                {
-                    rowsInPage[pageCounter][0] = i / this->columnCount;
-                    rowsInPage[pageCounter][1] = i % this->columnCount;
-                    rowsInPage[pageCounter][2] = stoi(word);
-                    pageCounter++;
-                }
-            }
+            MatrixPage page(this, pageIndex);
+            this->blockEncodings[pageIndex] = bufferManager.writeMatrixPage(this->matrixName, pageIndex, page.rows, page.rowCount);
         }
-
-        if (pageCounter == this->maxRowsPerBlock)
-        {
-            bufferManager.writeMatrixPage(this->matrixName, curPageIndex, rowsInPage, pageCounter);
-            this->dimPerBlockCount[curPageIndex] = {pageCounter, numAttributes};
-            curPageIndex++;
-            pageCounter = 0;
-        }
-    }
-
-    if (pageCounter)
-    {
-        bufferManager.writeMatrixPage(this->matrixName, curPageIndex, rowsInPage, pageCounter);
-        this->dimPerBlockCount[curPageIndex] = {pageCounter, numAttributes};
-        curPageIndex++;
-        pageCounter = 0;
     }
-
-    fin.close();
 }
 
 /**
@@ -336,69 +285,17 @@ bool Matrix::setStatistics()
     while (getline(s, word, ','))
         this->columnCount++;
 
-    this->isSparseMatrix = this->isSparse();
-
-    if (!this->isSparseMatrix)
-    {
-        // TODO: sizeof(int) + 1? (1 for spaces): not needed prolly
-        this->maxRowsPerBlock = (uint)sqrt((BLOCK_SIZE * 1024) / sizeof(int));
-        this->blocksPerRow = this->columnCount / this->maxRowsPerBlock + (this->columnCount % this->maxRowsPerBlock != 0);
-        this->blockCount = this->blocksPerRow * this->blocksPerRow;
-        this->rowCount = this->columnCount;
-        this->dimPerBlockCount.assign(this->blockCount, {0, 0});
-    }
-
-    else
-    {
-        this->maxRowsPerBlock = (uint)(BLOCK_SIZE * 1024) / (sizeof(int) * 3);
-        this->rowCount = this->columnCount;
-        this->blockCount = ((this->columnCount * this->columnCount) - this->numOfZeros + this->maxRowsPerBlock - 1) / this->maxRowsPerBlock;
-        this->dimPerBlockCount.assign(this->blockCount, {0, 0});
-    }
+    // TODO: sizeof(int) + 1? (1 for spaces): not needed prolly
+    this->maxRowsPerBlock = (uint)sqrt((BLOCK_SIZE * 1024) / sizeof(int));
+    this->blocksPerRow = this->columnCount / this->maxRowsPerBlock + (this->columnCount % this->maxRowsPerBlock != 0);
+    this->blockCount = this->blocksPerRow * this->blocksPerRow;
+    this->rowCount = this->columnCount;
+    this->dimPerBlockCount.assign(this->blockCount, {0, 0});
+    this->blockEncodings.assign(this->blockCount, DENSE_TILE);
 
     return true;
 }
 
-bool Matrix::isSparse()
-{
-    logger.log("Matrix::isSparse");
-    ifstream fin(this->sourceFileName, ios::in);
-
-    string word;
-
-    int numOfZeros = 0;
-
-    for (int i = 0; i < this->columnCount * this->columnCount; i++)
-    {
-        if ((i + 1) % this->columnCount != 0)
-        {
-            if (getline(fin, word, ','))
-            {
-                word.erase(remove_if(word.begin(), word.end(), ::isspace), word.end());
-                numOfZeros += (stoi(word) == 0);
-            }
-        }
-
-        else
-        {
-            if (getline(fin, word, '\n'))
-            {
-                word.erase(remove_if(word.begin(), word.end(), ::isspace), word.end());
-                numOfZeros += (stoi(word) == 0);
-            }
-        }
-    }
-
-    float zeros_percentage = (float)numOfZeros / (float)(this->columnCount * this->columnCount);
-    fin.close();
-
-    // cout << numOfZeros << " " << zeros_percentage << " " << (int)(zeros_percentage >= SPARSE_PERCENTAGE) << endl;
-
-    this->numOfZeros = numOfZeros;
-
-    return zeros_percentage >= SPARSE_PERCENTAGE;
-}
-
 /**
  * @brief Transposes matrix by swaping block_ij and block_ji elements for each i, j.
  *
@@ -407,75 +304,64 @@ bool Matrix::isSparse()
 void Matrix::transpose()
 {
     logger.log("Matrix::transpose");
-    if (this->isSparseMatrix)
-    {
-        this->sparseTranspose();
-    }
-
-    else
-    {
-        this->normalTranspose();
-    }
+    this->normalTranspose();
 }
 
+/**
+ * @brief Exchanges every block (i, j) with block (j, i), both transposed, and
+ * transposes blocks on the diagonal on their own. Pairs of blocks don't depend
+ * on each other, so they are handed out one at a time to workers of the
+ * thread pool. A worker reads its pair into pages of its own rather than the
+ * shared pool and writes them back before taking the next, so no more than
+ * MEMORY_BLOCK_COUNT blocks are held at once. Pairs of zero blocks are
+ * skipped, and every block written records the encoding that now suits it.
+ * Pairs without dense blocks aren't read at all: their files are exchanged and
+ * sparse blocks change between rows and columns.
+ *
+ */
 void Matrix::normalTranspose()
 {
     logger.log("Matrix::normalTranspose");
-
+    vector<pair<int, int>> blockPairs;
     for (int block_i = 0; block_i < this->blocksPerRow; block_i++)
-    {
         for (int block_j = block_i; block_j < this->blocksPerRow; block_j++)
+            blockPairs.push_back({block_i * this->blocksPerRow + block_j, block_j * this->blocksPerRow + block_i});
+
+    int workerCount = max(min({(int)WORKER_COUNT, (int)MEMORY_BLOCK_COUNT / 2, (int)blockPairs.size()}), 1);
+    atomic<int> nextPair(0);
+    auto work = [&]() {
+        for (int pairIndex = nextPair++; pairIndex < blockPairs.size(); pairIndex = nextPair++)
         {
-            if (block_i != block_j)
+            int block_ij = blockPairs[pairIndex].first, block_ji = blockPairs[pairIndex].second;
+            TileEncoding encoding_ij = this->blockEncodings[block_ij], encoding_ji = this->blockEncodings[block_ji];
+            if (encoding_ij == ZERO_TILE && encoding_ji == ZERO_TILE)
+                continue;
+            if (encoding_ij != DENSE_TILE && encoding_ji != DENSE_TILE)
             {
-                int block_ij = block_i * this->blocksPerRow + block_j, block_ji = block_j * this->blocksPerRow + block_i;
-                MatrixPage *page_ij = bufferManager.getMatrixPage(this->matrixName, block_ij);
-                MatrixPage *page_ji = bufferManager.getMatrixPage(this->matrixName, block_ji);
-                page_ij = bufferManager.getMatrixPage(this->matrixName, block_ij);
-
-                page_ij->transpose(page_ji);
-                page_ij->writePage();
-                page_ji->writePage();
+                if (block_ij != block_ji)
+                    bufferManager.swapMatrixPages(this->matrixName, block_ij, block_ji);
+                this->blockEncodings[block_ij] = MatrixPage::getTransposedEncoding(encoding_ji);
+                this->blockEncodings[block_ji] = MatrixPage::getTransposedEncoding(encoding_ij);
+                continue;
             }
+            MatrixPage page_ij = bufferManager.readMatrixPage(this->matrixName, block_ij);
+            if (block_ij == block_ji)
+                page_ij.transpose();
             else
             {
-                int block_ij = block_i * this->blocksPerRow + block_j;
-                MatrixPage *page_ij = bufferManager.getMatrixPage(this->matrixName, block_ij);
-                page_ij->transpose();
-                page_ij->writePage();
+                MatrixPage page_ji = bufferManager.readMatrixPage(this->matrixName, block_ji);
+                page_ij.transpose(&page_ji);
+                this->blockEncodings[block_ji] = bufferManager.writeMatrixPage(this->matrixName, block_ji, page_ji.rows, page_ji.rowCount);
             }
+            this->blockEncodings[block_ij] = bufferManager.writeMatrixPage(this->matrixName, block_ij, page_ij.rows, page_ij.rowCount);
         }
-    }
-}
-
-void Matrix::sparseTranspose()
-{
-    logger.log("Matrix::sparseTranspose");
-    for (int block = 0; block < this->blockCount; block++)
-    {
-        MatrixPage *curPage = bufferManager.getMatrixPage(this->matrixName, block);
-        curPage->sparseTranspose();
-        curPage->writePage();
-    }
-
-    for (int block_i = 0; block_i < this->blockCount; block_i++)
-    {
-
-        for (int block_j = block_i + 1; block_j < this->blockCount; block_j++)
-        {
-            MatrixPage *page_j = bufferManager.getMatrixPage(this->matrixName, block_j);
-            MatrixPage *page_i = bufferManager.getMatrixPage(this->matrixName, block_i);
-            page_j = bufferManager.getMatrixPage(this->matrixName, block_j);
+    };
 
-            // cout << "before sort " << block_i << " " << block_j << " " << this->blockCount << endl;
-            page_i->sortTwoPages(page_j);
-            // cout << "after sort " << block_i << " " << block_j << " " << this->blockCount << endl;
-
-            page_i->writePage();
-            page_j->writePage();
-        }
-
-    }
+    TaskGroup workers;
+    for (int workerIndex = 1; workerIndex < workerCount; workerIndex++)
+        workers.submit(work);
+    work();
+    workers.wait();
 }
 
 /**
@@ -488,16 +374,7 @@ void Matrix::sparseTranspose()
 void Matrix::print()
 {
     logger.log("Matrix::print");
-
-    if (this->isSparseMatrix)
-    {
-        this->printSparseMatrix();
-    }
-
-    else
-    {
-        this->printNormalMatrix();
-    }
+    this->printNormalMatrix();
 }
 
 void Matrix::printNormalMatrix()
@@ -536,46 +413,6 @@ void Matrix::printNormalMatrix()
     printRowCount(this->rowCount);
 }
 
-void Matrix::printSparseMatrix()
-{
-    logger.log("Matrix::printSparseMatrix");
-    uint count = min((long long)PRINT_COUNT, this->rowCount);
-
-    CursorMatrix cursor = this->getCursor();
-    vector<int> curTuple = cursor.getNext();
-
-    while (curTuple.size() > 0 && curTuple[1] >= count)
-    {
-        curTuple = cursor.getNext();
-    }
-
-    for (int rowCounter = 0; rowCounter < count; rowCounter++)
-    {
-        vector<int> curRow;
-
-        for (int colCounter = 0; colCounter < count; colCounter++)
-        {
-            int value = 0;
-            if (curTuple.size() > 0 && curTuple[0] == rowCounter && curTuple[1] == colCounter)
-            {
-                value = curTuple[2];
-                curTuple = cursor.getNext();
-
-                while (curTuple.size() > 0 && curTuple[1] >= count)
-                {
-                    curTuple = cursor.getNext();
-                }
-            }
-
-            curRow.push_back(value);
-        }
-
-        this->writeRow(curRow, cout, 1, 1);
-    }
-
-    printRowCount(this->rowCount);
-}
-
 /**
  * @brief This function moves cursor to next page if next page exists.
  *
@@ -630,16 +467,7 @@ void Matrix::makePermanent()
     logger.log("Matrix::makePermanent");
     if (!this->isPermanent())
         bufferManager.deleteFile(this->sourceFileName);
-
-    if (!this->isSparseMatrix)
-    {
-        this->makeNormalPermanent();
-    }
-
-    else
-    {
-        this->makeSparsePermanent();
-    }
+    this->makeNormalPermanent();
 }
 
 void Matrix::makeNormalPermanent()
@@ -658,41 +486,6 @@ void Matrix::makeNormalPermanent()
     fout.close();
 }
 
-void Matrix::makeSparsePermanent()
-{
-    logger.log("Matrix::makeSparsePermanent");
-
-    string newSourceFile = "../data/" + this->matrixName + ".csv";
-    ofstream fout(newSourceFile, ios::out);
-
-    CursorMatrix cursor = this->getCursor();
-    vector<int> curTuple = cursor.getNext();
-
-    for (int rowCounter = 0; rowCounter < this->columnCount; rowCounter++)
-    {
-        for (int colCounter = 0; colCounter < this->columnCount; colCounter++)
-        {
-            int value = 0;
-            if (curTuple.size() > 0 && curTuple[0] == rowCounter && curTuple[1] == colCounter)
-            {
-                value = curTuple[2];
-                curTuple = cursor.getNext();
-            }
-
-            if (colCounter != 0)
-            {
-                fout << ",";
-            }
-
-            fout << value;
-        }
-
-        fout << endl;
-    }
-
-    fout.close();
-}
-
 /**
  * @brief Function to check if matrix is already exported
  *
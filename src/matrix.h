@@ -11,9 +11,7 @@ class Matrix
     bool setStatistics();
     vector<int> readRowSegment(int numOfWords, ifstream &fin, bool isLastBlock);
     void writeRowSegment(vector<int> &rowSegment, int pageIndex);
-    bool isSparse();
     void normalBlockify();
-    void sparseBlockify();
 
     bool slowBlockify();
     vector<int> slowReadRowSegment(int columnPointer, int columnsInBlock, ifstream &fin);
@@ -26,22 +24,17 @@ public:
     uint blockCount = 0;
     uint blocksPerRow = 0;
     uint maxRowsPerBlock = 0;
-    uint numOfZeros = 0;
-    bool isSparseMatrix = false;
-    float SPARSE_PERCENTAGE = 0.6;
     vector<pair<uint, uint>> dimPerBlockCount;
+    vector<TileEncoding> blockEncodings;
 
     Matrix(string matrixName);
     bool load();
     void print();
     void printNormalMatrix();
-    void printSparseMatrix();
     void transpose();
     void normalTranspose();
-    void sparseTranspose();
     void makePermanent();
     void makeNormalPermanent();
-    void makeSparsePermanent();
     bool isPermanent();
     void getNextPage(CursorMatrix *cursor);
     void getNextPointer(CursorMatrix *cursor);
@@ -0,0 +1,766 @@
+#include "global.h"
+
+/**
+ * @brief Estimates the fraction of rows satisfying condition from the number
+ * of distinct values in the compared columns, assuming uniformly distributed
+ * values. Range comparisons are assumed to keep a third of the rows.
+ */
+static double estimateSelectivity(const BoundCondition &condition, const vector<uint> &distinctValuesPerColumnCount)
+{
+    double distinctCount = distinctValuesPerColumnCount[condition.firstColumnIndex];
+    if (condition.secondColumnIndex >= 0)
+        distinctCount = max(distinctCount, (double)distinctValuesPerColumnCount[condition.secondColumnIndex]);
+    distinctCount = max(distinctCount, 1.0);
+    switch (condition.binaryOperator)
+    {
+    case EQUAL:
+        return 1 / distinctCount;
+    case NOT_EQUAL:
+        return 1 - 1 / distinctCount;
+    default:
+        return 1.0 / 3;
+    }
+}
+
+/**
+ * @brief Binds a parsed SELECT condition to the given columns. Comparisons
+ * within an AND-group are ordered by increasing selectivity, so that the later
+ * ones only see the few rows that survived the first, and the AND-groups of an
+ * OR by decreasing selectivity, so that rows are taken out of consideration as
+ * early as possible.
+ *
+ * @param conditions OR of AND-groups of comparisons
+ * @param columns
+ * @param distinctValuesPerColumnCount
+ * @return vector<vector<BoundCondition>>
+ */
+vector<vector<BoundCondition>> bindConditions(const vector<vector<SelectionCondition>> &conditions, const vector<string> &columns, const vector<uint> &distinctValuesPerColumnCount)
+{
+    vector<vector<BoundCondition>> conjunctions;
+    vector<double> conjunctionSelectivities;
+    for (auto &conjunction : conditions)
+    {
+        vector<BoundCondition> boundConjunction;
+        double conjunctionSelectivity = 1;
+        for (auto &condition : conjunction)
+        {
+            bool isLiteral = condition.selectType == INT_LITERAL;
+            BoundCondition boundCondition;
+            boundCondition.firstColumnIndex = find(columns.begin(), columns.end(), condition.firstColumnName) - columns.begin();
+            boundCondition.secondColumnIndex = isLiteral ? -1 : find(columns.begin(), columns.end(), condition.secondColumnName) - columns.begin();
+            boundCondition.intLiteral = condition.intLiteral;
+            boundCondition.binaryOperator = condition.binaryOperator;
+            boundCondition.kernel = getPredicateKernel(condition.binaryOperator, isLiteral);
+            boundCondition.selectivity = estimateSelectivity(boundCondition, distinctValuesPerColumnCount);
+            conjunctionSelectivity *= boundCondition.selectivity;
+            boundConjunction.emplace_back(boundCondition);
+        }
+        stable_sort(boundConjunction.begin(), boundConjunction.end(), [](const BoundCondition &first, const BoundCondition &second) { return first.selectivity < second.selectivity; });
+        conjunctions.emplace_back(boundConjunction);
+        conjunctionSelectivities.emplace_back(conjunctionSelectivity);
+    }
+
+    vector<int> order(conjunctions.size());
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&](int first, int second) { return conjunctionSelectivities[first] > conjunctionSelectivities[second]; });
+    vector<vector<BoundCondition>> orderedConjunctions;
+    for (int conjunctionIndex : order)
+        orderedConjunctions.emplace_back(conjunctions[conjunctionIndex]);
+    return orderedConjunctions;
+}
+
+/**
+ * @brief Estimates the fraction of rows satisfying a bound condition, taking
+ * the comparisons of an AND-group and the AND-groups of an OR to be
+ * independent.
+ *
+ * @param conjunctions
+ * @return double
+ */
+double getSelectivity(const vector<vector<BoundCondition>> &conjunctions)
+{
+    double rejectedFraction = 1;
+    for (auto &conjunction : conjunctions)
+    {
+        double conjunctionSelectivity = 1;
+        for (auto &condition : conjunction)
+            conjunctionSelectivity *= condition.selectivity;
+        rejectedFraction *= 1 - conjunctionSelectivity;
+    }
+    return 1 - rejectedFraction;
+}
+
+/**
+ * @brief Reads all of input into rows if it has at most memoryRowCount rows.
+ * Otherwise the rows read so far and the rest of input are written to a
+ * temporary table, which is returned with isTemporary set. An input that is a
+ * plain scan of a table too big for memory is returned as that table without
+ * being copied.
+ *
+ * @return Table* NULL if input was read into rows
+ */
+static Table *materialize(Operator *input, long long memoryRowCount, vector<vector<int>> &rows, bool &isTemporary)
+{
+    logger.log("materialize");
+    isTemporary = false;
+    rows.clear();
+    Table *table = input->getTable();
+    if (table && table->rowCount > memoryRowCount)
+        return table;
+
+    RowPointers batch;
+    unique_ptr<PageWriter> writer;
+    while (input->next(batch))
+    {
+        for (auto row : batch)
+        {
+            if (!writer && rows.size() == memoryRowCount)
+            {
+                table = new Table(tableCatalogue.getTempTableName(input->relationName + "_Spill"), input->columns);
+                tableCatalogue.insertTable(table);
+                writer.reset(new PageWriter(table));
+                for (auto &rowInMemory : rows)
+                    writer->writeRow(rowInMemory);
+                rows.clear();
+            }
+            if (writer)
+                writer->writeRow(*row);
+            else
+                rows.emplace_back(*row);
+        }
+    }
+    if (!writer)
+        return NULL;
+    writer->close();
+    isTemporary = true;
+    return table;
+}
+
+/**
+ * @brief Reads the current values of the counters kept by the buffer manager
+ * and the cursors, and the CPU time used by the process.
+ *
+ * @return OperatorStatistics
+ */
+OperatorStatistics OperatorStatistics::getCounters()
+{
+    OperatorStatistics counters;
+    counters.rowsRead = Cursor::rowReadCount;
+    counters.pageReads = bufferManager.pageReadCount;
+    counters.bufferHits = bufferManager.bufferHitCount;
+    counters.pageWrites = bufferManager.pageWriteCount;
+    counters.cpuSeconds = (double)clock() / CLOCKS_PER_SEC;
+    return counters;
+}
+
+/**
+ * @brief Adds the work done between two readings of the counters.
+ *
+ * @param start
+ * @param end
+ */
+void OperatorStatistics::add(const OperatorStatistics &start, const OperatorStatistics &end)
+{
+    this->rowsOut += end.rowsOut - start.rowsOut;
+    this->rowsRead += end.rowsRead - start.rowsRead;
+    this->pageReads += end.pageReads - start.pageReads;
+    this->bufferHits += end.bufferHits - start.bufferHits;
+    this->pageWrites += end.pageWrites - start.pageWrites;
+    this->cpuSeconds += end.cpuSeconds - start.cpuSeconds;
+}
+
+/**
+ * @brief Passes on the next batch of rows of the operator, recording the work
+ * it took in the operator's statistics.
+ *
+ * @param rows
+ * @return true if rows isn't empty
+ * @return false once the operator is exhausted
+ */
+bool Operator::next(RowPointers &rows)
+{
+    OperatorStatistics start = OperatorStatistics::getCounters();
+    bool hasRows = this->getNextBatch(rows);
+    this->statistics.add(start, OperatorStatistics::getCounters());
+    this->statistics.rowsOut += rows.size();
+    return hasRows;
+}
+
+vector<Operator *> Operator::getInputs()
+{
+    return {};
+}
+
+/**
+ * @brief Returns the table the operator reads as a whole, without having
+ * started reading it, so that disk based algorithms can use it directly.
+ *
+ * @return Table* NULL for operators computing their rows
+ */
+Table *Operator::getTable()
+{
+    return NULL;
+}
+
+int Operator::getColumnIndex(string columnName)
+{
+    auto column = find(this->columns.begin(), this->columns.end(), columnName);
+    return column == this->columns.end() ? -1 : column - this->columns.begin();
+}
+
+/**
+ * @brief Number of rows of this operator's width that fit in a block.
+ *
+ * @return uint
+ */
+uint Operator::getMaxRowsPerBlock()
+{
+    return max((uint)((BLOCK_SIZE * 1000) / (sizeof(int) * this->columns.size())), 1u);
+}
+
+/**
+ * @brief Pulls all rows out of the operator and writes them to writer.
+ *
+ * @param writer
+ * @return long long number of rows written
+ */
+long long Operator::drain(PageWriter &writer)
+{
+    logger.log("Operator::drain");
+    long long rowCount = 0;
+    RowPointers rows;
+    while (this->next(rows))
+    {
+        for (auto row : rows)
+            writer.writeRow(*row);
+        rowCount += rows.size();
+    }
+    return rowCount;
+}
+
+/**
+ * @brief Reads table a page at a time. The rows passed on are those of the
+ * cursor's page, nothing is copied. A table owned by the scan is a temporary
+ * result and is deleted along with the scan.
+ *
+ * @param table
+ * @param ownsTable
+ */
+ScanOperator::ScanOperator(Table *table, bool ownsTable)
+{
+    logger.log("ScanOperator::ScanOperator");
+    this->table = table;
+    this->ownsTable = ownsTable;
+    this->relationName = table->tableName;
+    this->columns = table->columns;
+    this->distinctValuesPerColumnCount = table->distinctValuesPerColumnCount;
+    this->estimatedRowCount = table->rowCount;
+}
+
+bool ScanOperator::getNextBatch(RowPointers &rows)
+{
+    rows.clear();
+    if (!this->cursor)
+    {
+        if (!this->table->rowCount)
+            return false;
+        this->cursor = new Cursor(this->table->getCursor());
+    }
+    RowBatch batch = this->cursor->getNextBatch();
+    for (auto &row : batch)
+        rows.emplace_back(&row);
+    return !rows.empty();
+}
+
+/**
+ * @brief Restricts the scan to the pages from firstPageIndex up to (but not
+ * including) endPageIndex and restarts it there. A scan that is given one
+ * morsel after another reads only those pages.
+ *
+ * @param firstPageIndex
+ * @param endPageIndex
+ */
+void ScanOperator::setPageRange(int firstPageIndex, int endPageIndex)
+{
+    delete this->cursor;
+    this->cursor = new Cursor(this->table->tableName, firstPageIndex, endPageIndex);
+}
+
+PhysicalPlan ScanOperator::getPlan()
+{
+    return planScan(this->table);
+}
+
+Table *ScanOperator::getTable()
+{
+    return this->cursor ? NULL : this->table;
+}
+
+ScanOperator::~ScanOperator()
+{
+    delete this->cursor;
+    if (this->ownsTable)
+        tableCatalogue.deleteTable(this->table->tableName);
+}
+
+/**
+ * @brief Passes on the rows of child that satisfy a SELECT condition (an OR of
+ * AND-groups of comparisons). Every AND-group is evaluated one comparison at
+ * a time on the rows of the batch that are still candidates, stopping as soon
+ * as none are left. Rows selected by an AND-group are not looked at by the
+ * following ones.
+ *
+ * @param child
+ * @param conditions
+ */
+FilterOperator::FilterOperator(unique_ptr<Operator> child, const vector<vector<SelectionCondition>> &conditions)
+{
+    logger.log("FilterOperator::FilterOperator");
+    this->child = move(child);
+    this->relationName = this->child->relationName;
+    this->columns = this->child->columns;
+    this->distinctValuesPerColumnCount = this->child->distinctValuesPerColumnCount;
+    this->conjunctions = bindConditions(conditions, this->columns, this->distinctValuesPerColumnCount);
+
+    this->estimatedRowCount = ceil(this->child->estimatedRowCount * getSelectivity(this->conjunctions));
+}
+
+vector<Operator *> FilterOperator::getInputs()
+{
+    return {this->child.get()};
+}
+
+PhysicalPlan FilterOperator::getPlan()
+{
+    PhysicalPlan plan;
+    plan.physicalOperator = FILTER;
+    plan.detail = describeConditions(this->conjunctions, this->columns);
+    plan.estimatedRowCount = this->estimatedRowCount;
+    plan.inputs.emplace_back(this->child->getPlan());
+    return plan;
+}
+
+/**
+ * @brief Narrows the candidates, positions in the input batch, down to those
+ * satisfying condition. Only the candidates' values are gathered into column
+ * chunks and compared.
+ */
+void FilterOperator::filterCandidates(const BoundCondition &condition)
+{
+    int candidateCount = this->candidates.size();
+    this->values1.resize(candidateCount);
+    for (int candidateCounter = 0; candidateCounter < candidateCount; candidateCounter++)
+        this->values1[candidateCounter] = (*this->inputRows[this->candidates[candidateCounter]])[condition.firstColumnIndex];
+    if (condition.secondColumnIndex >= 0)
+    {
+        this->values2.resize(candidateCount);
+        for (int candidateCounter = 0; candidateCounter < candidateCount; candidateCounter++)
+            this->values2[candidateCounter] = (*this->inputRows[this->candidates[candidateCounter]])[condition.secondColumnIndex];
+    }
+    this->selection.resize(candidateCount);
+    int selectedCount = condition.kernel(this->values1.data(), this->values2.data(), condition.intLiteral, candidateCount, this->selection.data());
+    for (int selectedCounter = 0; selectedCounter < selectedCount; selectedCounter++)
+        this->candidates[selectedCounter] = this->candidates[this->selection[selectedCounter]];
+    this->candidates.resize(selectedCount);
+}
+
+bool FilterOperator::getNextBatch(RowPointers &rows)
+{
+    rows.clear();
+    while (rows.empty())
+    {
+        if (!this->child->next(this->inputRows))
+            return false;
+        int rowCount = this->inputRows.size();
+        this->remaining.resize(rowCount);
+        iota(this->remaining.begin(), this->remaining.end(), 0);
+        this->selected.assign(rowCount, false);
+        for (auto &conjunction : this->conjunctions)
+        {
+            this->candidates = this->remaining;
+            for (int conditionCounter = 0; conditionCounter < conjunction.size() && !this->candidates.empty(); conditionCounter++)
+                this->filterCandidates(conjunction[conditionCounter]);
+            if (this->candidates.empty())
+                continue;
+            for (int position : this->candidates)
+                this->selected[position] = true;
+            this->remaining.erase(remove_if(this->remaining.begin(), this->remaining.end(), [&](int position) { return this->selected[position]; }), this->remaining.end());
+            if (this->remaining.empty())
+                break;
+        }
+        for (int rowCounter = 0; rowCounter < rowCount; rowCounter++)
+            if (this->selected[rowCounter])
+                rows.emplace_back(this->inputRows[rowCounter]);
+    }
+    return true;
+}
+
+/**
+ * @brief Passes on the given columns of the rows of child, in the given order.
+ *
+ * @param child
+ * @param columnList
+ */
+ProjectOperator::ProjectOperator(unique_ptr<Operator> child, const vector<string> &columnList)
+{
+    logger.log("ProjectOperator::ProjectOperator");
+    this->child = move(child);
+    this->relationName = this->child->relationName;
+    this->columns = columnList;
+    for (auto &columnName : columnList)
+    {
+        this->columnIndices.emplace_back(this->child->getColumnIndex(columnName));
+        this->distinctValuesPerColumnCount.emplace_back(this->child->distinctValuesPerColumnCount[this->columnIndices.back()]);
+    }
+    this->estimatedRowCount = this->child->estimatedRowCount;
+}
+
+vector<Operator *> ProjectOperator::getInputs()
+{
+    return {this->child.get()};
+}
+
+PhysicalPlan ProjectOperator::getPlan()
+{
+    PhysicalPlan plan;
+    plan.physicalOperator = PROJECT;
+    for (int columnCounter = 0; columnCounter < this->columns.size(); columnCounter++)
+        plan.detail += (columnCounter ? ", " : "") + this->columns[columnCounter];
+    plan.estimatedRowCount = this->estimatedRowCount;
+    plan.inputs.emplace_back(this->child->getPlan());
+    return plan;
+}
+
+bool ProjectOperator::getNextBatch(RowPointers &rows)
+{
+    rows.clear();
+    if (!this->child->next(this->inputRows))
+        return false;
+    this->outputRows.resize(this->inputRows.size());
+    for (int rowCounter = 0; rowCounter < this->inputRows.size(); rowCounter++)
+    {
+        vector<int> &outputRow = this->outputRows[rowCounter];
+        outputRow.resize(this->columnIndices.size());
+        for (int columnCounter = 0; columnCounter < this->columnIndices.size(); columnCounter++)
+            outputRow[columnCounter] = (*this->inputRows[rowCounter])[this->columnIndices[columnCounter]];
+        rows.emplace_back(&outputRow);
+    }
+    return true;
+}
+
+/**
+ * @brief Joins the rows of left with those of right on leftColumn
+ * binaryOperator rightColumn, or computes their cross product if
+ * binaryOperator is NO_BINOP_CLAUSE. Columns are named as in JOIN and CROSS
+ * statements, with the relation names of the two inputs.
+ *
+ * <p>
+ * Right is read into memory first, into a hash table on the join column for
+ * equi-joins, and left is streamed past it. If right doesn't fit in
+ * MEMORY_BLOCK_COUNT - 2 blocks both inputs are written to temporary tables
+ * and joined with the disk based algorithms of the JOIN and CROSS statements.
+ * </p>
+ *
+ */
+JoinOperator::JoinOperator(unique_ptr<Operator> left, unique_ptr<Operator> right, int leftColumnIndex, int rightColumnIndex, BinaryOperator binaryOperator)
+{
+    logger.log("JoinOperator::JoinOperator");
+    this->left = move(left);
+    this->right = move(right);
+    this->leftColumnIndex = leftColumnIndex;
+    this->rightColumnIndex = rightColumnIndex;
+    this->binaryOperator = binaryOperator;
+    this->relationName = this->left->relationName;
+    this->columns = getJoinColumns(this->left->relationName, this->left->columns, this->right->relationName, this->right->columns);
+    this->distinctValuesPerColumnCount = this->left->distinctValuesPerColumnCount;
+    this->distinctValuesPerColumnCount.insert(this->distinctValuesPerColumnCount.end(), this->right->distinctValuesPerColumnCount.begin(), this->right->distinctValuesPerColumnCount.end());
+
+    uint leftDistinctValueCount = leftColumnIndex >= 0 ? this->left->distinctValuesPerColumnCount[leftColumnIndex] : 0;
+    uint rightDistinctValueCount = rightColumnIndex >= 0 ? this->right->distinctValuesPerColumnCount[rightColumnIndex] : 0;
+    this->estimatedRowCount = estimateJoinRowCount(this->left->estimatedRowCount, leftDistinctValueCount, this->right->estimatedRowCount, rightDistinctValueCount, binaryOperator);
+}
+
+/**
+ * @brief Describes the output of input, joined on columnIndex, to the planner.
+ */
+static JoinInput getJoinInput(Operator *input, int columnIndex)
+{
+    JoinInput joinInput;
+    joinInput.plan = input->getPlan();
+    joinInput.table = input->getTable();
+    joinInput.relationName = input->relationName;
+    joinInput.columnIndex = columnIndex;
+    if (columnIndex >= 0)
+    {
+        joinInput.columnName = input->columns[columnIndex];
+        joinInput.distinctValueCount = input->distinctValuesPerColumnCount[columnIndex];
+    }
+    joinInput.rowCount = input->estimatedRowCount;
+    joinInput.blockCount = ceil((double)input->estimatedRowCount / input->getMaxRowsPerBlock());
+    return joinInput;
+}
+
+vector<Operator *> JoinOperator::getInputs()
+{
+    return {this->left.get(), this->right.get()};
+}
+
+/**
+ * @brief If right is expected to fit in memory the join is pipelined and
+ * reads nothing beyond its inputs. Otherwise it is planned like a JOIN of
+ * the two inputs, plus writing and reading back the inputs that aren't
+ * tables and the result.
+ */
+PhysicalPlan JoinOperator::getPlan()
+{
+    JoinInput leftInput = getJoinInput(this->left.get(), this->leftColumnIndex);
+    JoinInput rightInput = getJoinInput(this->right.get(), this->rightColumnIndex);
+    long long memoryRowCount = (long long)max((int)MEMORY_BLOCK_COUNT - 2, 1) * this->right->getMaxRowsPerBlock();
+    if (this->right->estimatedRowCount <= memoryRowCount)
+    {
+        PhysicalPlan plan;
+        plan.physicalOperator = this->binaryOperator == EQUAL ? HASH_JOIN : BLOCK_NESTED_LOOP_JOIN;
+        plan.firstIsOuter = false;
+        plan.detail = describeJoin(leftInput, rightInput, this->binaryOperator) + ", in memory: " + rightInput.relationName;
+        plan.estimatedRowCount = this->estimatedRowCount;
+        plan.inputs = {leftInput.plan, rightInput.plan};
+        return plan;
+    }
+
+    PhysicalPlan plan = planJoin(leftInput, rightInput, this->binaryOperator);
+    for (JoinInput *input : {&leftInput, &rightInput})
+    {
+        if (!input->table)
+        {
+            plan.blockWrites += input->blockCount;
+            plan.blockReads += input->blockCount;
+        }
+    }
+    double resultBlockCount = ceil((double)this->estimatedRowCount / this->getMaxRowsPerBlock());
+    plan.blockWrites += resultBlockCount;
+    plan.blockReads += resultBlockCount;
+    return plan;
+}
+
+void JoinOperator::prepare()
+{
+    logger.log("JoinOperator::prepare");
+    this->prepared = true;
+    long long memoryRowCount = (long long)max((int)MEMORY_BLOCK_COUNT - 2, 1) * this->right->getMaxRowsPerBlock();
+    bool rightIsTemporary;
+    Table *rightTable = materialize(this->right.get(), memoryRowCount, this->rightRows, rightIsTemporary);
+    if (rightTable)
+    {
+        this->spill(rightTable, rightIsTemporary);
+        return;
+    }
+
+    this->outputRows.resize(this->getMaxRowsPerBlock());
+    if (this->binaryOperator == NO_BINOP_CLAUSE)
+    {
+        this->allRightPositions.resize(this->rightRows.size());
+        iota(this->allRightPositions.begin(), this->allRightPositions.end(), 0);
+    }
+    else if (this->binaryOperator == EQUAL)
+    {
+        for (int rowCounter = 0; rowCounter < this->rightRows.size(); rowCounter++)
+            this->rightPositionsByValue[this->rightRows[rowCounter][this->rightColumnIndex]].emplace_back(rowCounter);
+    }
+    else
+    {
+        //left op right is evaluated as right mirror(op) left, with the value
+        //of the left row as the literal
+        this->rightValues.resize(this->rightRows.size());
+        for (int rowCounter = 0; rowCounter < this->rightRows.size(); rowCounter++)
+            this->rightValues[rowCounter] = this->rightRows[rowCounter][this->rightColumnIndex];
+        this->kernel = getPredicateKernel(mirrorBinaryOperator(this->binaryOperator), true);
+    }
+}
+
+/**
+ * @brief Joins the two inputs on disk once right turned out to be too big for
+ * memory. The result is written to a temporary table that next() then scans.
+ */
+void JoinOperator::spill(Table *rightTable, bool rightIsTemporary)
+{
+    logger.log("JoinOperator::spill");
+    bool leftIsTemporary;
+    vector<vector<int>> leftRowsInMemory;
+    Table *leftTable = materialize(this->left.get(), 0, leftRowsInMemory, leftIsTemporary);
+    this->leftExhausted = true;
+    if (leftTable)
+    {
+        Table *resultantTable = new Table(tableCatalogue.getTempTableName(this->relationName + "_Join"), this->columns);
+        tableCatalogue.insertTable(resultantTable);
+        PageWriter writer(resultantTable);
+        if (this->binaryOperator == NO_BINOP_CLAUSE)
+            blockNestedLoopJoin(leftTable, -1, rightTable, -1, NO_BINOP_CLAUSE, writer);
+        else
+            joinTables(leftTable, this->leftColumnIndex, rightTable, this->rightColumnIndex, this->binaryOperator, writer);
+        writer.close();
+        this->spilledResult.reset(new ScanOperator(resultantTable, true));
+        if (leftIsTemporary)
+            tableCatalogue.deleteTable(leftTable->tableName);
+    }
+    if (rightIsTemporary)
+        tableCatalogue.deleteTable(rightTable->tableName);
+}
+
+/**
+ * @brief Points matches at the positions of the right rows that join with
+ * leftRow.
+ */
+void JoinOperator::findMatches(const vector<int> &leftRow)
+{
+    static const vector<int> noMatches;
+    this->matchPosition = 0;
+    if (this->binaryOperator == NO_BINOP_CLAUSE)
+        this->matches = &this->allRightPositions;
+    else if (this->binaryOperator == EQUAL)
+    {
+        auto bucket = this->rightPositionsByValue.find(leftRow[this->leftColumnIndex]);
+        this->matches = bucket == this->rightPositionsByValue.end() ? &noMatches : &bucket->second;
+    }
+    else
+    {
+        this->selection.resize(this->rightValues.size());
+        this->selection.resize(this->kernel(this->rightValues.data(), NULL, leftRow[this->leftColumnIndex], this->rightValues.size(), this->selection.data()));
+        this->matches = &this->selection;
+    }
+}
+
+bool JoinOperator::getNextBatch(RowPointers &rows)
+{
+    if (!this->prepared)
+        this->prepare();
+    if (this->spilledResult)
+        return this->spilledResult->next(rows);
+
+    rows.clear();
+    int outputCount = 0;
+    while (outputCount < this->outputRows.size())
+    {
+        if (this->matches && this->matchPosition < this->matches->size())
+        {
+            const vector<int> &leftRow = *this->leftRows[this->leftPosition];
+            const vector<int> &rightRow = this->rightRows[(*this->matches)[this->matchPosition++]];
+            vector<int> &outputRow = this->outputRows[outputCount++];
+            outputRow.assign(leftRow.begin(), leftRow.end());
+            outputRow.insert(outputRow.end(), rightRow.begin(), rightRow.end());
+            continue;
+        }
+        if (this->leftExhausted)
+            break;
+        if (++this->leftPosition >= (int)this->leftRows.size())
+        {
+            this->leftPosition = 0;
+            do
+            {
+                if (!this->left->next(this->leftRows))
+                    this->leftExhausted = true;
+            } while (!this->leftExhausted && this->leftRows.empty());
+            if (this->leftExhausted)
+            {
+                this->matches = NULL;
+                break;
+            }
+        }
+        this->findMatches(*this->leftRows[this->leftPosition]);
+    }
+    for (int rowCounter = 0; rowCounter < outputCount; rowCounter++)
+        rows.emplace_back(&this->outputRows[rowCounter]);
+    return outputCount > 0;
+}
+
+/**
+ * @brief Passes on the rows of child sorted on a column, keeping only the
+ * first limit rows if limit isn't negative. Ties keep the order of child. The
+ * rows are sorted in memory if they fit in MEMORY_BLOCK_COUNT blocks and with
+ * the external merge sort of the SORT statement otherwise.
+ *
+ * @param child
+ * @param columnIndex
+ * @param sortingStrategy
+ * @param limit
+ */
+SortOperator::SortOperator(unique_ptr<Operator> child, int columnIndex, SortingStrategy sortingStrategy, int limit)
+{
+    logger.log("SortOperator::SortOperator");
+    this->child = move(child);
+    this->columnIndex = columnIndex;
+    this->sortingStrategy = sortingStrategy;
+    this->limit = limit;
+    this->relationName = this->child->relationName;
+    this->columns = this->child->columns;
+    this->distinctValuesPerColumnCount = this->child->distinctValuesPerColumnCount;
+    this->estimatedRowCount = limit < 0 ? this->child->estimatedRowCount : min(this->child->estimatedRowCount, (long long)limit);
+}
+
+vector<Operator *> SortOperator::getInputs()
+{
+    return {this->child.get()};
+}
+
+/**
+ * @brief Sorts in memory if child is expected to fit in MEMORY_BLOCK_COUNT
+ * blocks, otherwise with the external sort, after writing child to a
+ * temporary table unless it is a table, and reading the sorted table back.
+ */
+PhysicalPlan SortOperator::getPlan()
+{
+    double blockCount = ceil((double)this->child->estimatedRowCount / this->child->getMaxRowsPerBlock());
+    bool spills = blockCount > MEMORY_BLOCK_COUNT;
+    PhysicalPlan plan = planSort(this->child->getPlan(), blockCount, this->limit, spills);
+    if (spills)
+    {
+        plan.blockReads += blockCount;
+        if (!this->child->getTable())
+        {
+            plan.blockWrites += blockCount;
+            plan.blockReads += blockCount;
+        }
+    }
+    plan.detail = "BY " + this->columns[this->columnIndex] + (this->sortingStrategy == ASC ? " ASC" : " DESC");
+    if (this->limit >= 0)
+        plan.detail += " LIMIT " + to_string(this->limit);
+    return plan;
+}
+
+void SortOperator::prepare()
+{
+    logger.log("SortOperator::prepare");
+    this->prepared = true;
+    long long memoryRowCount = (long long)MEMORY_BLOCK_COUNT * this->child->getMaxRowsPerBlock();
+    bool isTemporary;
+    Table *table = materialize(this->child.get(), memoryRowCount, this->sortedRows, isTemporary);
+    if (!table)
+    {
+        int columnIndex = this->columnIndex;
+        if (this->sortingStrategy == ASC)
+            stable_sort(this->sortedRows.begin(), this->sortedRows.end(), [columnIndex](const vector<int> &first, const vector<int> &second) { return first[columnIndex] < second[columnIndex]; });
+        else
+            stable_sort(this->sortedRows.begin(), this->sortedRows.end(), [columnIndex](const vector<int> &first, const vector<int> &second) { return first[columnIndex] > second[columnIndex]; });
+        if (this->limit >= 0 && this->sortedRows.size() > this->limit)
+            this->sortedRows.resize(this->limit);
+        return;
+    }
+
+    Table *sortedTable = sortTable(table, tableCatalogue.getTempTableName(this->relationName + "_Sorted"), {this->columnIndex}, this->sortingStrategy, this->limit);
+    if (isTemporary)
+        tableCatalogue.deleteTable(table->tableName);
+    this->spilledResult.reset(new ScanOperator(sortedTable, true));
+}
+
+bool SortOperator::getNextBatch(RowPointers &rows)
+{
+    if (!this->prepared)
+        this->prepare();
+    if (this->spilledResult)
+        return this->spilledResult->next(rows);
+
+    rows.clear();
+    long long batchEnd = min(this->sortedPosition + this->getMaxRowsPerBlock(), (long long)this->sortedRows.size());
+    for (; this->sortedPosition < batchEnd; this->sortedPosition++)
+        rows.emplace_back(&this->sortedRows[this->sortedPosition]);
+    return !rows.empty();
+}
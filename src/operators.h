@@ -0,0 +1,193 @@
+#include"predicate.h"
+
+/**
+ * @brief Rows passed from an operator to its parent. Rows are referenced, not
+ * copied: they belong to the operator that produced them (or to the page its
+ * cursor is on) and stay valid until that operator's next call to next().
+ *
+ */
+typedef vector<const vector<int> *> RowPointers;
+
+/**
+ * @brief A comparison of a SELECT condition bound to the columns of its input,
+ * with its kernel picked and its selectivity estimated.
+ *
+ */
+struct BoundCondition
+{
+    int firstColumnIndex;
+    int secondColumnIndex;
+    int intLiteral;
+    BinaryOperator binaryOperator;
+    PredicateKernel kernel;
+    double selectivity;
+};
+
+vector<vector<BoundCondition>> bindConditions(const vector<vector<SelectionCondition>> &conditions, const vector<string> &columns, const vector<uint> &distinctValuesPerColumnCount);
+double getSelectivity(const vector<vector<BoundCondition>> &conjunctions);
+
+struct PhysicalPlan;
+
+/**
+ * @brief Counters of the work done by an operator during execution, for
+ * EXPLAIN ANALYZE. They include the work done in the next() calls of its
+ * inputs.
+ *
+ */
+struct OperatorStatistics
+{
+    long long rowsOut = 0;
+    //Rows read through cursors
+    long long rowsRead = 0;
+    long long pageReads = 0;
+    long long bufferHits = 0;
+    long long pageWrites = 0;
+    double cpuSeconds = 0;
+
+    static OperatorStatistics getCounters();
+    void add(const OperatorStatistics &start, const OperatorStatistics &end);
+};
+
+/**
+ * @brief Physical operators form a tree through which rows are pulled batch by
+ * batch: every call to next() on the root asks its children for as many
+ * batches as it needs to produce one of its own. Pipelined operators (scan,
+ * filter, project and the probe side of a join) never store their input. The
+ * ones that need all of an input (sort and the build side of a join) keep it
+ * in memory while it fits in MEMORY_BLOCK_COUNT blocks and only spill it to a
+ * temporary table otherwise.
+ *
+ * <p>
+ * Every operator describes its output with a column list, the relation name
+ * used to prefix clashing columns when it is joined, and estimates of its row
+ * count and of the distinct values per column.
+ * </p>
+ *
+ */
+class Operator
+{
+public:
+    string relationName = "";
+    vector<string> columns;
+    vector<uint> distinctValuesPerColumnCount;
+    long long estimatedRowCount = 0;
+    OperatorStatistics statistics;
+
+    bool next(RowPointers &rows);
+    virtual PhysicalPlan getPlan() = 0;
+    virtual vector<Operator *> getInputs();
+    virtual Table *getTable();
+    virtual ~Operator() {}
+    int getColumnIndex(string columnName);
+    uint getMaxRowsPerBlock();
+    long long drain(PageWriter &writer);
+
+protected:
+    virtual bool getNextBatch(RowPointers &rows) = 0;
+};
+
+class ScanOperator : public Operator
+{
+    Table *table;
+    bool ownsTable;
+    Cursor *cursor = NULL;
+
+    bool getNextBatch(RowPointers &rows);
+
+public:
+    ScanOperator(Table *table, bool ownsTable = false);
+    void setPageRange(int firstPageIndex, int endPageIndex);
+    PhysicalPlan getPlan();
+    Table *getTable();
+    ~ScanOperator();
+};
+
+class FilterOperator : public Operator
+{
+    unique_ptr<Operator> child;
+    vector<vector<BoundCondition>> conjunctions;
+    RowPointers inputRows;
+    vector<int> remaining, candidates, values1, values2, selection;
+    vector<bool> selected;
+
+    void filterCandidates(const BoundCondition &condition);
+    bool getNextBatch(RowPointers &rows);
+
+public:
+    FilterOperator(unique_ptr<Operator> child, const vector<vector<SelectionCondition>> &conditions);
+    PhysicalPlan getPlan();
+    vector<Operator *> getInputs();
+};
+
+class ProjectOperator : public Operator
+{
+    unique_ptr<Operator> child;
+    vector<int> columnIndices;
+    RowPointers inputRows;
+    vector<vector<int>> outputRows;
+
+    bool getNextBatch(RowPointers &rows);
+
+public:
+    ProjectOperator(unique_ptr<Operator> child, const vector<string> &columnList);
+    PhysicalPlan getPlan();
+    vector<Operator *> getInputs();
+};
+
+class JoinOperator : public Operator
+{
+    unique_ptr<Operator> left;
+    unique_ptr<Operator> right;
+    int leftColumnIndex;
+    int rightColumnIndex;
+    BinaryOperator binaryOperator;
+    bool prepared = false;
+
+    //In memory right input
+    vector<vector<int>> rightRows;
+    vector<int> rightValues;
+    vector<int> allRightPositions;
+    unordered_map<int, vector<int>> rightPositionsByValue;
+    PredicateKernel kernel = NULL;
+
+    RowPointers leftRows;
+    int leftPosition = -1;
+    bool leftExhausted = false;
+    vector<int> selection;
+    const vector<int> *matches = NULL;
+    int matchPosition = 0;
+    vector<vector<int>> outputRows;
+
+    //Result of the join when the right input had to be spilled
+    unique_ptr<Operator> spilledResult;
+
+    void prepare();
+    void spill(Table *rightTable, bool rightIsTemporary);
+    void findMatches(const vector<int> &leftRow);
+    bool getNextBatch(RowPointers &rows);
+
+public:
+    JoinOperator(unique_ptr<Operator> left, unique_ptr<Operator> right, int leftColumnIndex, int rightColumnIndex, BinaryOperator binaryOperator);
+    PhysicalPlan getPlan();
+    vector<Operator *> getInputs();
+};
+
+class SortOperator : public Operator
+{
+    unique_ptr<Operator> child;
+    int columnIndex;
+    SortingStrategy sortingStrategy;
+    int limit;
+    bool prepared = false;
+    vector<vector<int>> sortedRows;
+    long long sortedPosition = 0;
+    unique_ptr<Operator> spilledResult;
+
+    void prepare();
+    bool getNextBatch(RowPointers &rows);
+
+public:
+    SortOperator(unique_ptr<Operator> child, int columnIndex, SortingStrategy sortingStrategy, int limit = -1);
+    PhysicalPlan getPlan();
+    vector<Operator *> getInputs();
+};
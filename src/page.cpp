@@ -1,4 +1,136 @@
 #include "global.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define TRANSPOSE_SIMD
+#endif
+
+/**
+ * @brief Matrix pages are transposed tile by tile, so that both the rows read
+ * and the rows written stay in cache while a tile is worked on. A tile is 8x8,
+ * one AVX2 register per tile row.
+ */
+const int TRANSPOSE_TILE_SIZE = 8;
+
+typedef void (*TransposeTileKernel)(int *const *rows, int column, int *const *mirrorRows, int mirrorColumn);
+
+/**
+ * @brief Swaps element (i, j) of the rowCount x columnCount tile starting at
+ * column of rows with element (j, i) of its mirror tile, which starts at
+ * mirrorColumn of mirrorRows. A tile on the diagonal is its own mirror and is
+ * transposed in place. Used for the tiles cut short by the edge of a page and
+ * on processors without AVX2.
+ */
+static void transposeTileScalar(int *const *rows, int column, int *const *mirrorRows, int mirrorColumn, int rowCount, int columnCount)
+{
+    bool isDiagonal = rows == mirrorRows && column == mirrorColumn;
+    for (int rowCounter = 0; rowCounter < rowCount; rowCounter++)
+        for (int columnCounter = isDiagonal ? rowCounter + 1 : 0; columnCounter < columnCount; columnCounter++)
+            swap(rows[rowCounter][column + columnCounter], mirrorRows[columnCounter][mirrorColumn + rowCounter]);
+}
+
+static void transposeFullTileScalar(int *const *rows, int column, int *const *mirrorRows, int mirrorColumn)
+{
+    transposeTileScalar(rows, column, mirrorRows, mirrorColumn, TRANSPOSE_TILE_SIZE, TRANSPOSE_TILE_SIZE);
+}
+
+#ifdef TRANSPOSE_SIMD
+/**
+ * @brief Transposes a tile held in registers: rows are interleaved in pairs of
+ * 32 bit values, then of 64 bit values, and the 128 bit lanes are finally
+ * exchanged between rows four apart.
+ */
+__attribute__((target("avx2"))) static inline void transposeRegisters(__m256i *tile)
+{
+    __m256i pairs[TRANSPOSE_TILE_SIZE], quads[TRANSPOSE_TILE_SIZE];
+    for (int rowCounter = 0; rowCounter < TRANSPOSE_TILE_SIZE; rowCounter += 2)
+    {
+        pairs[rowCounter] = _mm256_unpacklo_epi32(tile[rowCounter], tile[rowCounter + 1]);
+        pairs[rowCounter + 1] = _mm256_unpackhi_epi32(tile[rowCounter], tile[rowCounter + 1]);
+    }
+    for (int rowCounter = 0; rowCounter < TRANSPOSE_TILE_SIZE; rowCounter += 4)
+    {
+        quads[rowCounter] = _mm256_unpacklo_epi64(pairs[rowCounter], pairs[rowCounter + 2]);
+        quads[rowCounter + 1] = _mm256_unpackhi_epi64(pairs[rowCounter], pairs[rowCounter + 2]);
+        quads[rowCounter + 2] = _mm256_unpacklo_epi64(pairs[rowCounter + 1], pairs[rowCounter + 3]);
+        quads[rowCounter + 3] = _mm256_unpackhi_epi64(pairs[rowCounter + 1], pairs[rowCounter + 3]);
+    }
+    for (int rowCounter = 0; rowCounter < 4; rowCounter++)
+    {
+        tile[rowCounter] = _mm256_permute2x128_si256(quads[rowCounter], quads[rowCounter + 4], 0x20);
+        tile[rowCounter + 4] = _mm256_permute2x128_si256(quads[rowCounter], quads[rowCounter + 4], 0x31);
+    }
+}
+
+/**
+ * @brief Loads a full tile and its mirror, one register per tile row,
+ * transposes both and stores each in place of the other. Everything is loaded
+ * before anything is stored, so a tile on the diagonal may be its own mirror.
+ */
+__attribute__((target("avx2"))) static void transposeFullTileAVX2(int *const *rows, int column, int *const *mirrorRows, int mirrorColumn)
+{
+    __m256i tile[TRANSPOSE_TILE_SIZE], mirrorTile[TRANSPOSE_TILE_SIZE];
+    for (int rowCounter = 0; rowCounter < TRANSPOSE_TILE_SIZE; rowCounter++)
+    {
+        tile[rowCounter] = _mm256_loadu_si256((const __m256i *)(rows[rowCounter] + column));
+        mirrorTile[rowCounter] = _mm256_loadu_si256((const __m256i *)(mirrorRows[rowCounter] + mirrorColumn));
+    }
+    transposeRegisters(tile);
+    transposeRegisters(mirrorTile);
+    for (int rowCounter = 0; rowCounter < TRANSPOSE_TILE_SIZE; rowCounter++)
+    {
+        _mm256_storeu_si256((__m256i *)(rows[rowCounter] + column), mirrorTile[rowCounter]);
+        _mm256_storeu_si256((__m256i *)(mirrorRows[rowCounter] + mirrorColumn), tile[rowCounter]);
+    }
+}
+#endif
+
+/**
+ * @brief Picks the full tile kernel once, the AVX2 one when the processor
+ * supports it.
+ */
+static TransposeTileKernel getTransposeTileKernel()
+{
+#ifdef TRANSPOSE_SIMD
+    if (__builtin_cpu_supports("avx2"))
+        return transposeFullTileAVX2;
+#endif
+    return transposeFullTileScalar;
+}
+
+/**
+ * @brief Replaces the rowCount x columnCount matrix held in rows with the
+ * transpose of the columnCount x rowCount matrix held in mirrorRows and vice
+ * versa, one tile and its mirror tile at a time. Every row is a contiguous
+ * buffer, so a tile row is a single vector load. When both are the same square
+ * matrix it is transposed in place and only tiles on or above the diagonal are
+ * visited.
+ */
+static void transposeRows(int *const *rows, int *const *mirrorRows, int rowCount, int columnCount)
+{
+    static const TransposeTileKernel transposeFullTile = getTransposeTileKernel();
+    bool inPlace = rows == mirrorRows;
+    for (int tileRow = 0; tileRow < rowCount; tileRow += TRANSPOSE_TILE_SIZE)
+    {
+        int tileRowCount = min(TRANSPOSE_TILE_SIZE, rowCount - tileRow);
+        for (int tileColumn = inPlace ? tileRow : 0; tileColumn < columnCount; tileColumn += TRANSPOSE_TILE_SIZE)
+        {
+            int tileColumnCount = min(TRANSPOSE_TILE_SIZE, columnCount - tileColumn);
+            if (tileRowCount == TRANSPOSE_TILE_SIZE && tileColumnCount == TRANSPOSE_TILE_SIZE)
+                transposeFullTile(rows + tileRow, tileColumn, mirrorRows + tileColumn, tileRow);
+            else
+                transposeTileScalar(rows + tileRow, tileColumn, mirrorRows + tileColumn, tileRow, tileRowCount, tileColumnCount);
+        }
+    }
+}
+
+static vector<int *> getRowPointers(vector<vector<int>> &rows, int rowCount)
+{
+    vector<int *> rowPointers(rowCount);
+    for (int rowCounter = 0; rowCounter < rowCount; rowCounter++)
+        rowPointers[rowCounter] = rows[rowCounter].data();
+    return rowPointers;
+}
+
 /**
  * @brief Construct a new Page object. Never used as part of the code
  *
@@ -43,10 +175,10 @@ TablePage::TablePage(string tableName, int pageIndex)
     this->tableName = tableName;
     this->pageIndex = pageIndex;
     this->pageName = "../data/temp/" + this->tableName + "_Page" + to_string(pageIndex);
-    Table table = *tableCatalogue.getTable(tableName);
-    this->columnCount = table.columnCount;
-    this->rowCount = table.rowsPerBlockCount[pageIndex];
-    uint maxRowCount = table.maxRowsPerBlock;
+    Table *table = tableCatalogue.getTable(tableName);
+    this->columnCount = table->columnCount;
+    this->rowCount = table->rowsPerBlockCount[pageIndex];
+    uint maxRowCount = table->maxRowsPerBlock;
     this->rows.assign(maxRowCount, vector<int>(columnCount));
     this->fillRows();
 }
@@ -74,20 +206,33 @@ TablePage::TablePage(string tableName, int pageIndex, vector<vector<int>> rows,
  * @param matrixName
  * @param pageIndex
  */
-MatrixPage::MatrixPage(string matrixName, int pageIndex)
+MatrixPage::MatrixPage(string matrixName, int pageIndex) : MatrixPage(matrixCatalogue.getMatrix(matrixName), pageIndex)
 {
     logger.log("MatrixPage::MatrixPage2");
-    this->matrixName = matrixName;
-    this->pageIndex = pageIndex;
+}
 
-    // cout << "pageIndex is " << this->pageIndex << " " << pageIndex << endl;
+/**
+ * @brief Construct a new Page:: Page object given the matrix itself, for
+ * matrices that are not in the catalogue yet because they are being loaded.
+ * Zero tiles are not read from disk.
+ *
+ * @param matrix
+ * @param pageIndex
+ */
+MatrixPage::MatrixPage(Matrix *matrix, int pageIndex)
+{
+    logger.log("MatrixPage::MatrixPage4");
+    this->matrixName = matrix->matrixName;
+    this->pageIndex = pageIndex;
     this->pageName = "../data/temp/" + this->matrixName + "_Page" + to_string(pageIndex);
-    Matrix *matrix = matrixCatalogue.getMatrix(matrixName);
-    uint maxRowCount = matrix->maxRowsPerBlock;
     this->rowCount = matrix->dimPerBlockCount[pageIndex].first;
     this->columnCount = matrix->dimPerBlockCount[pageIndex].second;
-    this->rows.assign(this->rowCount, vector<int>(this->columnCount));
-    this->fillRows();
+    this->encoding = matrix->blockEncodings[pageIndex];
+    this->rows.assign(this->rowCount, vector<int>(this->columnCount, 0));
+    if (this->encoding == DENSE_TILE)
+        this->fillRows();
+    else if (this->encoding != ZERO_TILE)
+        this->fillCompressedRows();
 }
 
 MatrixPage::MatrixPage(string matrixName, int pageIndex, vector<vector<int>> rows, int rowCount)
@@ -104,95 +249,190 @@ MatrixPage::MatrixPage(string matrixName, int pageIndex, vector<vector<int>> row
 }
 
 /**
- * @brief Transposes rows of a single page
+ * @brief Reads a sparse tile into rows, which are all zeros: the pointers of
+ * its rows (columns for a sparse column tile), then the differences between
+ * the columns (rows) of their values and then the values.
  *
  */
-void MatrixPage::transpose()
+void MatrixPage::fillCompressedRows()
 {
-    logger.log("MatrixPage::transpose");
-    for (int i = 0; i < this->rowCount; i++)
-    {
-        for (int j = i + 1; j < this->columnCount; j++)
+    logger.log("MatrixPage::fillCompressedRows");
+    ifstream fin(this->pageName, ios::in);
+    bool isColumnMajor = this->encoding == SPARSE_COLUMN_TILE;
+    int lineCount = isColumnMajor ? this->columnCount : this->rowCount;
+    vector<int> linePointers(lineCount + 1);
+    for (int &linePointer : linePointers)
+        fin >> linePointer;
+
+    vector<int> positions(linePointers.back());
+    for (int lineCounter = 0; lineCounter < lineCount; lineCounter++)
+        for (int entry = linePointers[lineCounter], position = 0; entry < linePointers[lineCounter + 1]; entry++)
         {
-            swap(this->rows[i][j], this->rows[j][i]);
+            int positionDifference;
+            fin >> positionDifference;
+            position += positionDifference;
+            positions[entry] = position;
         }
-    }
+    for (int lineCounter = 0; lineCounter < lineCount; lineCounter++)
+        for (int entry = linePointers[lineCounter]; entry < linePointers[lineCounter + 1]; entry++)
+        {
+            if (isColumnMajor)
+                fin >> this->rows[positions[entry]][lineCounter];
+            else
+                fin >> this->rows[lineCounter][positions[entry]];
+        }
+    fin.close();
 }
 
-bool cmp(const vector<int> &a, const vector<int> &b)
+/**
+ * @brief Picks the encoding of a rowCount x columnCount tile: zero if it has
+ * no nonzero values, sparse if the row pointers and a column and value per
+ * nonzero value take fewer integers than all its values, dense otherwise.
+ *
+ * @return TileEncoding
+ */
+TileEncoding MatrixPage::getEncoding(int rowCount, int columnCount, long long nonzeroCount)
 {
-    if (a[0] == b[0])
-    {
-        return a[1] < b[1];
-    }
-
-    return a[0] < b[0];
+    if (!nonzeroCount)
+        return ZERO_TILE;
+    if (rowCount + 1 + 2 * nonzeroCount < (long long)rowCount * columnCount)
+        return SPARSE_TILE;
+    return DENSE_TILE;
 }
 
-void MatrixPage::sparseTranspose()
+/**
+ * @brief Encoding of the transpose of a tile held in the same file.
+ *
+ * @return TileEncoding
+ */
+TileEncoding MatrixPage::getTransposedEncoding(TileEncoding encoding)
 {
-    logger.log("MatrixPage::sparseTranspose");
+    if (encoding == SPARSE_TILE)
+        return SPARSE_COLUMN_TILE;
+    if (encoding == SPARSE_COLUMN_TILE)
+        return SPARSE_TILE;
+    return encoding;
+}
 
-    for (int i = 0; i < this->rowCount; i++)
+static void writeValues(const vector<int> &values, ofstream &fout)
+{
+    for (int valueCounter = 0; valueCounter < values.size(); valueCounter++)
     {
-        swap(this->rows[i][0], this->rows[i][1]);
+        if (valueCounter != 0)
+            fout << " ";
+        fout << values[valueCounter];
     }
-
-    sort(this->rows.begin(), this->rows.end(), cmp);
+    fout << endl;
 }
 
-void MatrixPage::sortTwoPages(MatrixPage *page)
+/**
+ * @brief writes current page contents to file in the encoding that suits
+ * them, which is kept in encoding. Writing a zero tile deletes its file.
+ *
+ */
+void MatrixPage::writePage()
 {
-    logger.log("MatrixPage::sortTwoPages");
-
-    // cout << this->rowCount << " " << page->rowCount << endl;
-
-    vector<vector<int>> allRows;
-
-    // cout << this->rows.size() << " " << page->rows.size() << endl;
-
-    for (int i = 0; i < this->rowCount; i++)
+    logger.log("MatrixPage::writePage");
+    vector<int> rowPointers(1, 0), columnDifferences, values;
+    for (int rowCounter = 0; rowCounter < this->rowCount; rowCounter++)
     {
-        allRows.push_back(this->rows[i]);
+        for (int columnCounter = 0, previousColumn = 0; columnCounter < this->columnCount; columnCounter++)
+        {
+            if (!this->rows[rowCounter][columnCounter])
+                continue;
+            columnDifferences.push_back(columnCounter - previousColumn);
+            values.push_back(this->rows[rowCounter][columnCounter]);
+            previousColumn = columnCounter;
+        }
+        rowPointers.push_back(values.size());
     }
 
-    for (int i = 0; i < page->rowCount; i++)
+    this->encoding = getEncoding(this->rowCount, this->columnCount, values.size());
+    if (this->encoding == ZERO_TILE)
     {
-        allRows.push_back(page->rows[i]);
+        remove(this->pageName.c_str());
+        return;
     }
-
-    // cout << allRows.size() << " reached midway in sort two pages" << endl;
-
-    sort(allRows.begin(), allRows.end(), cmp);
-
-    for (int i = 0; i < this->rowCount; i++)
+    if (this->encoding == DENSE_TILE)
     {
-        this->rows[i] = allRows[i];
+        Page::writePage();
+        return;
     }
+    ofstream fout(this->pageName, ios::trunc);
+    writeValues(rowPointers, fout);
+    writeValues(columnDifferences, fout);
+    writeValues(values, fout);
+    fout.close();
+}
 
-    for (int i = 0; i < page->rowCount; i++)
-    {
-        page->rows[i] = allRows[this->rowCount + i];
-    }
+IndexPage::IndexPage()
+{
+    logger.log("IndexPage::IndexPage1");
+    this->indexName = "";
+}
+
+/**
+ * @brief Construct a new Page:: Page object given the index name and page
+ * index. Index nodes are stored in files named "<indexname>_IndexPage<pageindex>".
+ * Every index page starts with a header row of three integers whose second
+ * value is the number of entry rows that follow it, so unlike table and matrix
+ * pages, index pages do not depend on statistics kept in a catalogue.
+ *
+ * @param indexName
+ * @param pageIndex
+ */
+IndexPage::IndexPage(string indexName, int pageIndex)
+{
+    logger.log("IndexPage::IndexPage2");
+    this->indexName = indexName;
+    this->pageIndex = pageIndex;
+    this->pageName = "../data/temp/" + this->indexName + "_IndexPage" + to_string(pageIndex);
+    this->columnCount = 3;
+    ifstream fin(this->pageName, ios::in);
+    vector<int> header(this->columnCount);
+    for (int columnCounter = 0; columnCounter < this->columnCount; columnCounter++)
+        fin >> header[columnCounter];
+    fin.close();
+    this->rowCount = header[1] + 1;
+    this->rows.assign(this->rowCount, vector<int>(this->columnCount));
+    this->fillRows();
+}
+
+IndexPage::IndexPage(string indexName, int pageIndex, vector<vector<int>> rows, int rowCount)
+{
+    logger.log("IndexPage::IndexPage3");
+    this->indexName = indexName;
+    this->pageIndex = pageIndex;
+    this->rows = rows;
+    this->rowCount = rowCount;
+    this->columnCount = rows[0].size();
+    this->pageName = "../data/temp/" + this->indexName + "_IndexPage" + to_string(pageIndex);
+}
 
-    // allRows.clear();
+/**
+ * @brief Transposes rows of a single page in place. Only diagonal blocks are
+ * transposed on their own, so the page is square.
+ *
+ */
+void MatrixPage::transpose()
+{
+    logger.log("MatrixPage::transpose");
+    vector<int *> rowPointers = getRowPointers(this->rows, this->rowCount);
+    transposeRows(rowPointers.data(), rowPointers.data(), this->rowCount, this->columnCount);
 }
 
 /**
- * @brief Given two pages, it transposes both of them without using extra memory, by swapping (i, j)
- * of the first page with (j, i) of the second page
+ * @brief Given two pages, it transposes both of them by swapping (i, j) of the
+ * first page with (j, i) of the second page. The second page has as many rows
+ * as the first has columns and vice versa.
  *
  */
 void MatrixPage::transpose(MatrixPage *page)
 {
     logger.log("MatrixPage::transpose");
-    for (int i = 0; i < this->rowCount; i++)
-    {
-        for (int j = 0; j < this->columnCount; j++)
-        {
-            swap(this->rows[i][j], page->rows[j][i]);
-        }
-    }
+    vector<int *> rowPointers = getRowPointers(this->rows, this->rowCount);
+    vector<int *> mirrorRowPointers = getRowPointers(page->rows, page->rowCount);
+    transposeRows(rowPointers.data(), mirrorRowPointers.data(), this->rowCount, this->columnCount);
 }
 
 /**
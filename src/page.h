@@ -1,4 +1,4 @@
-#include "logger.h"
+#include "threadPool.h"
 /**
  * @brief The Page object is the main memory representation of a physical page
  * (equivalent to a block). The page class and the page.h header file are at the
@@ -27,19 +27,50 @@ public:
     virtual void writePage();
 };
 
+class Matrix;
+
+/**
+ * @brief Every tile (block) of a matrix is stored in the encoding that takes
+ * the least space: row by row, compressed, or not at all if the tile holds
+ * zeros only. A compressed tile is kept by rows, or by columns once it has
+ * been transposed.
+ */
+enum TileEncoding
+{
+    DENSE_TILE,
+    SPARSE_TILE,
+    SPARSE_COLUMN_TILE,
+    ZERO_TILE
+};
+
+/**
+ * @brief A matrix page holds one tile of the matrix, row by row in memory
+ * whatever its encoding. On disk a sparse tile is in CSR form: a pointer per
+ * row to its first nonzero value plus one past the last, the column of every
+ * nonzero value as the difference to the previous column of the same row, and
+ * the values. A sparse column tile is in CSC form, the same layout with rows
+ * and columns exchanged, so that the file of a sparse tile is also the file of
+ * its transpose. A zero tile has no file.
+ */
 class MatrixPage : public Page
 {
     string matrixName;
 
+    void fillCompressedRows();
+
 public:
+    TileEncoding encoding = DENSE_TILE;
+
     MatrixPage();
     MatrixPage(string matrixName, int pageIndex);
+    MatrixPage(Matrix *matrix, int pageIndex);
     MatrixPage(string matrixName, int pageIndex, vector<vector<int>> rows, int rowCount);
     // MatrixPage(string matrixName, int pageIndex, vector<vector<int>> rows, int rowCount, int colCount);
     void transpose();
     void transpose(MatrixPage *page);
-    void sparseTranspose();
-    void sortTwoPages(MatrixPage *page);
+    static TileEncoding getEncoding(int rowCount, int columnCount, long long nonzeroCount);
+    static TileEncoding getTransposedEncoding(TileEncoding encoding);
+    void writePage();
 };
 
 class TablePage : public Page
@@ -51,3 +82,13 @@ public:
     TablePage(string tableName, int pageIndex);
     TablePage(string tableName, int pageIndex, vector<vector<int>> rows, int rowCount);
 };
+
+class IndexPage : public Page
+{
+    string indexName;
+
+public:
+    IndexPage();
+    IndexPage(string indexName, int pageIndex);
+    IndexPage(string indexName, int pageIndex, vector<vector<int>> rows, int rowCount);
+};
@@ -0,0 +1,62 @@
+#include "global.h"
+
+/**
+ * @brief Construct a new PageWriter object that appends pages to the given
+ * table. The table is expected to be empty i.e. freshly constructed with its
+ * columns.
+ *
+ * @param table
+ */
+PageWriter::PageWriter(Table *table)
+{
+    logger.log("PageWriter::PageWriter");
+    this->table = table;
+    this->rowsInPage.assign(table->maxRowsPerBlock, vector<int>(table->columnCount, 0));
+    this->distinctValuesInColumns.assign(table->columnCount, unordered_set<int>());
+    this->table->distinctValuesPerColumnCount.assign(table->columnCount, 0);
+}
+
+/**
+ * @brief Appends a row to the page being built. If the page fills up it is
+ * written out through the buffer manager.
+ *
+ * @param row
+ */
+void PageWriter::writeRow(const vector<int> &row)
+{
+    for (int columnCounter = 0; columnCounter < this->table->columnCount; columnCounter++)
+    {
+        this->rowsInPage[this->pageCounter][columnCounter] = row[columnCounter];
+        if (this->distinctValuesInColumns[columnCounter].insert(row[columnCounter]).second)
+            this->table->distinctValuesPerColumnCount[columnCounter]++;
+    }
+    this->table->rowCount++;
+    this->pageCounter++;
+    if (this->pageCounter == this->table->maxRowsPerBlock)
+    {
+        bufferManager.writePage(this->table->tableName, this->table->blockCount, this->rowsInPage, this->pageCounter);
+        this->table->blockCount++;
+        this->table->rowsPerBlockCount.emplace_back(this->pageCounter);
+        this->pageCounter = 0;
+    }
+}
+
+/**
+ * @brief Writes out the last partially filled page, if any.
+ *
+ * @return true if the table holds at least one row
+ * @return false otherwise
+ */
+bool PageWriter::close()
+{
+    logger.log("PageWriter::close");
+    if (this->pageCounter)
+    {
+        bufferManager.writePage(this->table->tableName, this->table->blockCount, this->rowsInPage, this->pageCounter);
+        this->table->blockCount++;
+        this->table->rowsPerBlockCount.emplace_back(this->pageCounter);
+        this->pageCounter = 0;
+    }
+    this->distinctValuesInColumns.clear();
+    return this->table->rowCount != 0;
+}
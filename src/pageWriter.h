@@ -0,0 +1,28 @@
+#include "table.h"
+
+/**
+ * @brief The PageWriter is the write side counterpart of the cursor. To fill a
+ * table created by an assignment statement, rows are written to a PageWriter
+ * which collects them in a single in-memory page and hands the page over to
+ * the buffer manager once it is full. Unlike writeRow followed by blockify,
+ * rows never make a round trip through the table's csv file.
+ *
+ * <p>
+ * The writer also keeps the table's statistics (row count, block count, rows
+ * per block and distinct values per column) up to date. Call close() once all
+ * rows have been written to flush the last partially filled page.
+ * </p>
+ *
+ */
+class PageWriter
+{
+    Table *table;
+    vector<vector<int>> rowsInPage;
+    int pageCounter = 0;
+    vector<unordered_set<int>> distinctValuesInColumns;
+
+public:
+    PageWriter(Table *table);
+    void writeRow(const vector<int> &row);
+    bool close();
+};
@@ -0,0 +1,118 @@
+#include "global.h"
+
+/**
+ * @brief Number of workers a scan of table is run with: WORKER_COUNT, but no
+ * more than the table has morsels.
+ *
+ * @param table
+ * @return int at least 1
+ */
+int getWorkerCount(Table *table)
+{
+    int morselCount = (table->blockCount + MORSEL_PAGE_COUNT - 1) / MORSEL_PAGE_COUNT;
+    return max(min((int)WORKER_COUNT, morselCount), 1);
+}
+
+/**
+ * @brief Calls processMorsel on every morsel of table from workerCount tasks
+ * of the thread pool, the calling thread running worker 0. If writer isn't
+ * NULL the rows every call outputs are written to it, in morsel order.
+ * Workers waiting for their turn to write block their thread, so
+ * processMorsel must not wait on a task group itself.
+ *
+ * @param table
+ * @param workerCount
+ * @param processMorsel
+ * @param writer
+ */
+void runMorsels(Table *table, int workerCount, const MorselFunction &processMorsel, PageWriter *writer)
+{
+    logger.log("runMorsels");
+    int morselCount = (table->blockCount + MORSEL_PAGE_COUNT - 1) / MORSEL_PAGE_COUNT;
+    atomic<int> nextMorsel(0);
+    mutex outputMutex;
+    condition_variable outputTurn;
+    int nextOutputMorsel = 0;
+
+    auto work = [&](int workerIndex) {
+        vector<vector<int>> output;
+        for (int morsel = nextMorsel++; morsel < morselCount; morsel = nextMorsel++)
+        {
+            int firstPageIndex = morsel * MORSEL_PAGE_COUNT;
+            output.clear();
+            processMorsel(workerIndex, firstPageIndex, min(firstPageIndex + MORSEL_PAGE_COUNT, (int)table->blockCount), output);
+            if (!writer)
+                continue;
+            unique_lock<mutex> lock(outputMutex);
+            outputTurn.wait(lock, [&] { return nextOutputMorsel == morsel; });
+            for (auto &row : output)
+                writer->writeRow(row);
+            nextOutputMorsel++;
+            outputTurn.notify_all();
+        }
+    };
+
+    TaskGroup workers;
+    for (int workerIndex = 1; workerIndex < workerCount; workerIndex++)
+        workers.submit([&work, workerIndex]() { work(workerIndex); });
+    work(0);
+    workers.wait();
+}
+
+/**
+ * @brief Reads table in parallel, calling processBatch on every batch of rows
+ * with the index of the worker that read it.
+ *
+ * @param table
+ * @param workerCount
+ * @param processBatch
+ * @param writer
+ */
+void parallelScan(Table *table, int workerCount, const BatchFunction &processBatch, PageWriter *writer)
+{
+    logger.log("parallelScan");
+    runMorsels(table, workerCount, [&](int workerIndex, int firstPageIndex, int endPageIndex, vector<vector<int>> &output) {
+        Cursor cursor(table->tableName, firstPageIndex, endPageIndex);
+        for (RowBatch batch = cursor.getNextBatch(); !batch.empty(); batch = cursor.getNextBatch())
+            processBatch(workerIndex, batch, output);
+    }, writer);
+}
+
+/**
+ * @brief Runs a pipeline of operators over table in parallel and writes its
+ * rows to writer. Every worker gets its own copy of the pipeline, built by
+ * buildPipeline on top of a scan of table, and runs it on one morsel after
+ * another. The pipeline may only hold operators that pass rows on as they
+ * come (filters and projections).
+ *
+ * @param table
+ * @param buildPipeline
+ * @param writer
+ * @return long long number of rows written
+ */
+long long parallelDrain(Table *table, const PipelineBuilder &buildPipeline, PageWriter &writer)
+{
+    logger.log("parallelDrain");
+    int workerCount = getWorkerCount(table);
+    if (workerCount == 1)
+        return buildPipeline(unique_ptr<Operator>(new ScanOperator(table)))->drain(writer);
+
+    vector<unique_ptr<Operator>> pipelines;
+    vector<ScanOperator *> scans;
+    for (int workerCounter = 0; workerCounter < workerCount; workerCounter++)
+    {
+        scans.emplace_back(new ScanOperator(table));
+        pipelines.emplace_back(buildPipeline(unique_ptr<Operator>(scans.back())));
+    }
+
+    atomic<long long> rowCount(0);
+    runMorsels(table, workerCount, [&](int workerIndex, int firstPageIndex, int endPageIndex, vector<vector<int>> &output) {
+        scans[workerIndex]->setPageRange(firstPageIndex, endPageIndex);
+        RowPointers rows;
+        while (pipelines[workerIndex]->next(rows))
+            for (auto row : rows)
+                output.emplace_back(*row);
+        rowCount += output.size();
+    }, &writer);
+    return rowCount;
+}
@@ -0,0 +1,34 @@
+#include"planner.h"
+
+/**
+ * @brief Morsel-driven parallel scans. The pages of the scanned table are cut
+ * into morsels of MORSEL_PAGE_COUNT consecutive pages which the workers (tasks
+ * of the thread pool) take from a shared atomic counter, the next one each
+ * time they are done with one. No worker is tied to a fixed share of the
+ * table, so a worker held up on a morsel leaves the remaining ones to the
+ * others.
+ *
+ * <p>
+ * A worker collects the output rows of a morsel in its own buffer. Buffers are
+ * appended to the resultant table in morsel order, so a parallel scan writes
+ * the same rows in the same order as a serial one. A worker that finishes a
+ * morsel before the ones preceding it waits for them to be appended first,
+ * which keeps at most one morsel of output per worker in memory.
+ * </p>
+ *
+ * <p>
+ * Anything the workers share besides the buffer manager, the catalogues
+ * (which they only read) and the logger must be synchronized by the caller.
+ * </p>
+ *
+ */
+const int MORSEL_PAGE_COUNT = 4;
+
+typedef function<void(int workerIndex, int firstPageIndex, int endPageIndex, vector<vector<int>> &output)> MorselFunction;
+typedef function<void(int workerIndex, const RowBatch &batch, vector<vector<int>> &output)> BatchFunction;
+typedef function<unique_ptr<Operator>(unique_ptr<Operator> scan)> PipelineBuilder;
+
+int getWorkerCount(Table *table);
+void runMorsels(Table *table, int workerCount, const MorselFunction &processMorsel, PageWriter *writer);
+void parallelScan(Table *table, int workerCount, const BatchFunction &processBatch, PageWriter *writer = NULL);
+long long parallelDrain(Table *table, const PipelineBuilder &buildPipeline, PageWriter &writer);
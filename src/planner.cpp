@@ -0,0 +1,519 @@
+#include "global.h"
+
+double PhysicalPlan::getTotalBlockReads() const
+{
+    double blockReads = this->blockReads;
+    for (auto &input : this->inputs)
+        blockReads += input.getTotalBlockReads();
+    return blockReads;
+}
+
+double PhysicalPlan::getTotalBlockWrites() const
+{
+    double blockWrites = this->blockWrites;
+    for (auto &input : this->inputs)
+        blockWrites += input.getTotalBlockWrites();
+    return blockWrites;
+}
+
+/**
+ * @brief Number of blocks operators may fill with rows of an input they hold
+ * in memory, after reserving one for reading and one for writing.
+ */
+static double getMemoryBlockCount()
+{
+    return max((int)MEMORY_BLOCK_COUNT - 2, 1);
+}
+
+static string getBinaryOperatorSymbol(BinaryOperator binaryOperator)
+{
+    switch (binaryOperator)
+    {
+    case LESS_THAN:
+        return "<";
+    case GREATER_THAN:
+        return ">";
+    case LEQ:
+        return "<=";
+    case GEQ:
+        return ">=";
+    case EQUAL:
+        return "==";
+    case NOT_EQUAL:
+        return "!=";
+    default:
+        return "";
+    }
+}
+
+static string getIndexingStrategyName(IndexingStrategy indexingStrategy)
+{
+    switch (indexingStrategy)
+    {
+    case BTREE:
+        return "BTREE";
+    case HASH:
+        return "HASH";
+    case BITMAP:
+        return "BITMAP";
+    default:
+        return "NOTHING";
+    }
+}
+
+static string getPhysicalOperatorName(PhysicalOperator physicalOperator)
+{
+    switch (physicalOperator)
+    {
+    case TABLE_SCAN:
+        return "TABLE SCAN";
+    case INDEX_SCAN:
+        return "INDEX SCAN";
+    case FILTER:
+        return "FILTER";
+    case PROJECT:
+        return "PROJECT";
+    case BLOCK_NESTED_LOOP_JOIN:
+        return "BLOCK NESTED LOOP JOIN";
+    case HASH_JOIN:
+        return "HASH JOIN";
+    case INDEX_NESTED_LOOP_JOIN:
+        return "INDEX NESTED LOOP JOIN";
+    case SORT_MERGE_JOIN:
+        return "SORT MERGE JOIN";
+    case IN_MEMORY_SORT:
+        return "IN-MEMORY SORT";
+    case TOP_K_SORT:
+        return "TOP-K SORT";
+    case EXTERNAL_SORT:
+        return "EXTERNAL SORT";
+    case HASH_DISTINCT:
+        return "HASH DISTINCT";
+    case PARTITIONED_HASH_DISTINCT:
+        return "PARTITIONED HASH DISTINCT";
+    case SORT_DISTINCT:
+        return "SORT DISTINCT";
+    case HASH_GROUP_BY:
+        return "HASH GROUP BY";
+    case PARTITIONED_HASH_GROUP_BY:
+        return "PARTITIONED HASH GROUP BY";
+    case SORT_GROUP_BY:
+        return "SORT GROUP BY";
+    default:
+        return "";
+    }
+}
+
+/**
+ * @brief Writes a bound SELECT condition back as text, with the comparisons in
+ * the order they are evaluated.
+ *
+ * @param conjunctions
+ * @param columns columns the condition is bound to
+ * @return string
+ */
+string describeConditions(const vector<vector<BoundCondition>> &conjunctions, const vector<string> &columns)
+{
+    string description;
+    for (int conjunctionCounter = 0; conjunctionCounter < conjunctions.size(); conjunctionCounter++)
+    {
+        if (conjunctionCounter)
+            description += " OR ";
+        for (int conditionCounter = 0; conditionCounter < conjunctions[conjunctionCounter].size(); conditionCounter++)
+        {
+            const BoundCondition &condition = conjunctions[conjunctionCounter][conditionCounter];
+            if (conditionCounter)
+                description += " AND ";
+            description += columns[condition.firstColumnIndex] + " " + getBinaryOperatorSymbol(condition.binaryOperator) + " ";
+            description += condition.secondColumnIndex >= 0 ? columns[condition.secondColumnIndex] : to_string(condition.intLiteral);
+        }
+    }
+    return description;
+}
+
+/**
+ * @brief Estimates the number of rows of a join from the distinct values of
+ * the join columns, assuming uniformly distributed values. Range comparisons
+ * are assumed to keep a third of the pairs. NO_BINOP_CLAUSE gives the size of
+ * the cross product.
+ */
+long long estimateJoinRowCount(long long firstRowCount, uint firstDistinctValueCount, long long secondRowCount, uint secondDistinctValueCount, BinaryOperator binaryOperator)
+{
+    double pairCount = (double)firstRowCount * secondRowCount;
+    double distinctCount = max({firstDistinctValueCount, secondDistinctValueCount, 1u});
+    switch (binaryOperator)
+    {
+    case NO_BINOP_CLAUSE:
+        return pairCount;
+    case EQUAL:
+        return ceil(pairCount / distinctCount);
+    case NOT_EQUAL:
+        return ceil(pairCount * (1 - 1 / distinctCount));
+    default:
+        return ceil(pairCount / 3);
+    }
+}
+
+PhysicalPlan planScan(Table *table)
+{
+    PhysicalPlan plan;
+    plan.physicalOperator = TABLE_SCAN;
+    plan.detail = table->tableName;
+    plan.estimatedRowCount = table->rowCount;
+    plan.blockReads = table->blockCount;
+    return plan;
+}
+
+/**
+ * @brief Chooses between scanning the table and searching its index for a
+ * SELECT. A scan reads every block once. A search reads the index pages and
+ * then every page holding a row matching the indexed comparison; with no
+ * knowledge of how rows are laid out, every matching row is assumed to be on
+ * a page of its own until all pages are read. Ties go to the scan, whose
+ * reads are sequential.
+ *
+ * @param table
+ * @param conjunctions condition bound to the columns of table
+ * @return PhysicalPlan INDEX_SCAN or FILTER over TABLE_SCAN
+ */
+PhysicalPlan planSelection(Table *table, const vector<vector<BoundCondition>> &conjunctions)
+{
+    logger.log("planSelection");
+    PhysicalPlan filter;
+    filter.physicalOperator = FILTER;
+    filter.detail = describeConditions(conjunctions, table->columns);
+    filter.estimatedRowCount = ceil(table->rowCount * getSelectivity(conjunctions));
+    filter.inputs.emplace_back(planScan(table));
+
+    int lowValue, highValue;
+    int indexedCondition = findIndexedCondition(table, conjunctions, lowValue, highValue);
+    if (indexedCondition < 0)
+        return filter;
+    double matchingRowCount = table->rowCount * conjunctions.front()[indexedCondition].selectivity;
+    PhysicalPlan indexScan;
+    indexScan.physicalOperator = INDEX_SCAN;
+    indexScan.detail = table->tableName + " USING " + getIndexingStrategyName(table->indexingStrategy) + " ON " + table->indexedColumn + " WHERE " + filter.detail;
+    indexScan.estimatedRowCount = filter.estimatedRowCount;
+    indexScan.blockReads = table->index->getSearchCost() + min(matchingRowCount, (double)table->blockCount);
+    return indexScan.blockReads < filter.getTotalBlockReads() ? indexScan : filter;
+}
+
+/**
+ * @brief Describes table (and its join column) as an input of a join.
+ *
+ * @param table
+ * @param columnIndex join column, -1 for cross products
+ * @return JoinInput
+ */
+JoinInput getJoinInput(Table *table, int columnIndex)
+{
+    JoinInput input;
+    input.plan = planScan(table);
+    input.table = table;
+    input.relationName = table->tableName;
+    input.columnIndex = columnIndex;
+    if (columnIndex >= 0)
+    {
+        input.columnName = table->columns[columnIndex];
+        input.distinctValueCount = table->distinctValuesPerColumnCount[columnIndex];
+    }
+    input.rowCount = table->rowCount;
+    input.blockCount = table->blockCount;
+    return input;
+}
+
+/**
+ * @brief Number of merge passes of the external sort over blockCount blocks:
+ * runs of MEMORY_BLOCK_COUNT blocks merged MEMORY_BLOCK_COUNT - 1 at a time.
+ */
+static int getMergePassCount(double blockCount)
+{
+    long long runCount = ceil(blockCount / MEMORY_BLOCK_COUNT);
+    long long mergeDegree = max((int)MEMORY_BLOCK_COUNT - 1, 2);
+    int passCount = 0;
+    for (; runCount > 1; passCount++)
+        runCount = (runCount + mergeDegree - 1) / mergeDegree;
+    return passCount;
+}
+
+/**
+ * @brief Plans sorting the output of input, blockCount blocks, with the
+ * external sort. It sorts in memory if a single run holds all rows, otherwise
+ * every merge pass reads and writes all blocks once.
+ *
+ * @param input
+ * @param blockCount
+ * @param limit number of rows kept, -1 for all
+ * @param isTemporary whether the sorted rows are written to a temporary table
+ * (counted here) instead of being the result of the statement
+ * @return PhysicalPlan IN_MEMORY_SORT or EXTERNAL_SORT
+ */
+PhysicalPlan planSort(const PhysicalPlan &input, double blockCount, int limit, bool isTemporary)
+{
+    int mergePassCount = getMergePassCount(blockCount);
+    PhysicalPlan plan;
+    plan.physicalOperator = mergePassCount ? EXTERNAL_SORT : IN_MEMORY_SORT;
+    plan.estimatedRowCount = limit < 0 ? input.estimatedRowCount : min(input.estimatedRowCount, (long long)limit);
+    plan.blockReads = blockCount * mergePassCount;
+    plan.blockWrites = blockCount * (mergePassCount + isTemporary);
+    plan.inputs.emplace_back(input);
+    return plan;
+}
+
+/**
+ * @brief Plans a SORT statement. A LIMIT whose rows fit in memory is answered
+ * with a single pass keeping the best rows in a heap, anything else with the
+ * external sort.
+ */
+PhysicalPlan planSort(Table *table, int limit)
+{
+    logger.log("planSort");
+    long long limitBlockCount = limit < 0 ? -1 : (limit + table->maxRowsPerBlock - 1) / table->maxRowsPerBlock;
+    if (limitBlockCount > 0 && limitBlockCount < MEMORY_BLOCK_COUNT)
+    {
+        PhysicalPlan plan;
+        plan.physicalOperator = TOP_K_SORT;
+        plan.estimatedRowCount = min(table->rowCount, (long long)limit);
+        plan.inputs.emplace_back(planScan(table));
+        return plan;
+    }
+    return planSort(planScan(table), table->blockCount, limit, false);
+}
+
+/**
+ * @brief Upper bound on the number of distinct rows of table: the product of
+ * the distinct value counts of its columns, capped at its row count.
+ */
+static long long estimateDistinctRowCount(Table *table)
+{
+    long long estimate = 1;
+    for (uint distinctValueCount : table->distinctValuesPerColumnCount)
+    {
+        estimate *= max(distinctValueCount, 1u);
+        if (estimate >= table->rowCount)
+            return table->rowCount;
+    }
+    return estimate;
+}
+
+/**
+ * @brief Plans a DISTINCT statement from the number of distinct rows the
+ * column statistics allow. If they fit in memory a single pass suffices, if
+ * they fit in few enough partitions the table is hash partitioned (one more
+ * write and read of the table), otherwise duplicates are removed by sorting.
+ * The estimated row count of the plan is that number of distinct rows.
+ */
+PhysicalPlan planDistinct(Table *table)
+{
+    logger.log("planDistinct");
+    PhysicalPlan plan;
+    plan.estimatedRowCount = estimateDistinctRowCount(table);
+    long long memoryRowCount = getMemoryBlockCount() * table->maxRowsPerBlock;
+    long long partitionCount = (plan.estimatedRowCount + memoryRowCount - 1) / memoryRowCount;
+    if (partitionCount <= 1)
+    {
+        plan.physicalOperator = HASH_DISTINCT;
+        plan.inputs.emplace_back(planScan(table));
+    }
+    else if (partitionCount <= max((int)MEMORY_BLOCK_COUNT - 1, 2))
+    {
+        plan.physicalOperator = PARTITIONED_HASH_DISTINCT;
+        plan.blockReads = plan.blockWrites = table->blockCount;
+        plan.inputs.emplace_back(planScan(table));
+    }
+    else
+    {
+        plan.physicalOperator = SORT_DISTINCT;
+        plan.blockReads = table->blockCount;
+        plan.inputs.emplace_back(planSort(planScan(table), table->blockCount, -1, true));
+    }
+    return plan;
+}
+
+/**
+ * @brief Plans a GROUP BY statement on the column at columnIndex of table. A
+ * table already stored in order of the column is aggregated group after group
+ * in a single pass. Otherwise the groups, as many as the column has distinct
+ * values, are aggregated in an in-memory hash table if they fit in memory, in
+ * hash partitions of the table if they fit in few enough of them and after
+ * sorting the table if not. The estimated row count of the plan is the number
+ * of groups.
+ *
+ * @param table
+ * @param columnIndex
+ * @param resultantColumnCount number of columns of a group, the group column
+ * and the aggregates
+ * @return PhysicalPlan
+ */
+PhysicalPlan planGroupBy(Table *table, int columnIndex, int resultantColumnCount)
+{
+    logger.log("planGroupBy");
+    PhysicalPlan plan;
+    plan.estimatedRowCount = min((long long)table->distinctValuesPerColumnCount[columnIndex], table->rowCount);
+    uint maxGroupsPerBlock = max((uint)((BLOCK_SIZE * 1000) / (sizeof(int) * resultantColumnCount)), 1u);
+    long long memoryGroupCount = getMemoryBlockCount() * maxGroupsPerBlock;
+    long long partitionCount = (plan.estimatedRowCount + memoryGroupCount - 1) / memoryGroupCount;
+    if (table->sortedColumn == table->columns[columnIndex])
+    {
+        plan.physicalOperator = SORT_GROUP_BY;
+        plan.inputs.emplace_back(planScan(table));
+    }
+    else if (partitionCount <= 1)
+    {
+        plan.physicalOperator = HASH_GROUP_BY;
+        plan.inputs.emplace_back(planScan(table));
+    }
+    else if (partitionCount <= max((int)MEMORY_BLOCK_COUNT - 1, 2))
+    {
+        plan.physicalOperator = PARTITIONED_HASH_GROUP_BY;
+        plan.blockReads = plan.blockWrites = table->blockCount;
+        plan.inputs.emplace_back(planScan(table));
+    }
+    else
+    {
+        plan.physicalOperator = SORT_GROUP_BY;
+        plan.blockReads = table->blockCount;
+        plan.inputs.emplace_back(planSort(planScan(table), table->blockCount, -1, true));
+    }
+    return plan;
+}
+
+/**
+ * @brief Writes the join condition of first and second as text, e.g. R.a == S.b
+ * or R x S for cross products.
+ */
+string describeJoin(const JoinInput &first, const JoinInput &second, BinaryOperator binaryOperator)
+{
+    if (binaryOperator == NO_BINOP_CLAUSE)
+        return first.relationName + " x " + second.relationName;
+    return first.relationName + "." + first.columnName + " " + getBinaryOperatorSymbol(binaryOperator) + " " + second.relationName + "." + second.columnName;
+}
+
+static bool isIndexedOn(const JoinInput &input)
+{
+    return input.table && input.table->indexed && input.table->index && input.table->indexedColumn == input.columnName;
+}
+
+/**
+ * @brief Plans an index nested loop join streaming outer and searching the
+ * index of inner once per outer row. Every search reads the index pages and
+ * one page per matching row, up to all of inner.
+ */
+static PhysicalPlan planIndexNestedLoopJoin(const JoinInput &outer, const JoinInput &inner)
+{
+    double matchesPerValue = (double)inner.rowCount / max(inner.distinctValueCount, 1u);
+    PhysicalPlan search;
+    search.physicalOperator = INDEX_SCAN;
+    search.detail = inner.relationName + " USING " + getIndexingStrategyName(inner.table->indexingStrategy) + " ON " + inner.columnName + " PER OUTER ROW";
+    search.estimatedRowCount = ceil(outer.rowCount * matchesPerValue);
+    search.blockReads = outer.rowCount * (inner.table->index->getSearchCost() + min(matchesPerValue, inner.blockCount));
+
+    PhysicalPlan plan;
+    plan.physicalOperator = INDEX_NESTED_LOOP_JOIN;
+    plan.inputs = {outer.plan, search};
+    plan.detail = ", outer: " + outer.relationName;
+    return plan;
+}
+
+/**
+ * @brief Chooses the join algorithm with the fewest estimated block I/Os:
+ *
+ * <ul>
+ * <li> block nested loop join, any operator: the smaller input is read in
+ * chunks of MEMORY_BLOCK_COUNT - 2 blocks and the other is read once per
+ * chunk </li>
+ * <li> hash join, equality: one pass if the smaller input fits in memory,
+ * otherwise both are partitioned first, an extra write and read of both </li>
+ * <li> index nested loop join, equality with an index on the join column of
+ * a base table: see planIndexNestedLoopJoin </li>
+ * <li> sort merge join, any comparison: both inputs are sorted, then read once
+ * more along with the inner pages of every match </li>
+ * </ul>
+ *
+ * Ties are broken in that order of preference, hash join first.
+ *
+ * @param first
+ * @param second
+ * @param binaryOperator NO_BINOP_CLAUSE for cross products
+ * @return PhysicalPlan
+ */
+PhysicalPlan planJoin(const JoinInput &first, const JoinInput &second, BinaryOperator binaryOperator)
+{
+    logger.log("planJoin");
+    long long estimatedRowCount = estimateJoinRowCount(first.rowCount, first.distinctValueCount, second.rowCount, second.distinctValueCount, binaryOperator);
+    vector<PhysicalPlan> candidates;
+
+    if (binaryOperator == EQUAL)
+    {
+        PhysicalPlan hashJoin;
+        hashJoin.physicalOperator = HASH_JOIN;
+        hashJoin.firstIsOuter = first.rowCount <= second.rowCount;
+        if (min(first.blockCount, second.blockCount) > getMemoryBlockCount())
+            hashJoin.blockReads = hashJoin.blockWrites = first.blockCount + second.blockCount;
+        hashJoin.inputs = {first.plan, second.plan};
+        hashJoin.detail = ", build: " + (hashJoin.firstIsOuter ? first : second).relationName;
+        candidates.emplace_back(hashJoin);
+
+        if (isIndexedOn(second))
+            candidates.emplace_back(planIndexNestedLoopJoin(first, second));
+        if (isIndexedOn(first))
+        {
+            candidates.emplace_back(planIndexNestedLoopJoin(second, first));
+            candidates.back().firstIsOuter = false;
+            swap(candidates.back().inputs[0], candidates.back().inputs[1]);
+        }
+    }
+
+    PhysicalPlan nestedLoopJoin;
+    nestedLoopJoin.physicalOperator = BLOCK_NESTED_LOOP_JOIN;
+    nestedLoopJoin.firstIsOuter = first.blockCount <= second.blockCount;
+    const JoinInput &outer = nestedLoopJoin.firstIsOuter ? first : second;
+    const JoinInput &inner = nestedLoopJoin.firstIsOuter ? second : first;
+    nestedLoopJoin.blockReads = max(ceil(outer.blockCount / getMemoryBlockCount()) - 1, 0.0) * inner.blockCount;
+    nestedLoopJoin.inputs = {first.plan, second.plan};
+    nestedLoopJoin.detail = ", outer: " + outer.relationName;
+    candidates.emplace_back(nestedLoopJoin);
+
+    if (binaryOperator != NO_BINOP_CLAUSE)
+    {
+        PhysicalPlan sortMergeJoin;
+        sortMergeJoin.physicalOperator = SORT_MERGE_JOIN;
+        sortMergeJoin.blockReads = first.blockCount + second.blockCount + estimatedRowCount * second.blockCount / max(second.rowCount, 1LL);
+        sortMergeJoin.inputs = {planSort(first.plan, first.blockCount, -1, true), planSort(second.plan, second.blockCount, -1, true)};
+        candidates.emplace_back(sortMergeJoin);
+    }
+
+    PhysicalPlan *cheapest = &candidates.front();
+    for (auto &candidate : candidates)
+        if (candidate.getTotalBlockReads() + candidate.getTotalBlockWrites() < cheapest->getTotalBlockReads() + cheapest->getTotalBlockWrites())
+            cheapest = &candidate;
+    cheapest->detail = describeJoin(first, second, binaryOperator) + cheapest->detail;
+    cheapest->estimatedRowCount = estimatedRowCount;
+    return *cheapest;
+}
+
+/**
+ * @brief Names the node of plan, without its inputs, e.g. "HASH JOIN R.a == S.a".
+ */
+string describePlan(const PhysicalPlan &plan)
+{
+    string description = getPhysicalOperatorName(plan.physicalOperator);
+    if (!plan.detail.empty())
+        description += " " + plan.detail;
+    return description;
+}
+
+/**
+ * @brief Prints plan as a tree, one node per line with its estimates, its
+ * inputs indented below it.
+ *
+ * @param plan
+ * @param depth
+ */
+void printPlan(const PhysicalPlan &plan, int depth)
+{
+    cout << string(4 * depth, ' ') << (depth ? "-> " : "") << describePlan(plan);
+    cout << "  (rows: " << plan.estimatedRowCount << ", block reads: " << (long long)ceil(plan.blockReads) << ", block writes: " << (long long)ceil(plan.blockWrites) << ")" << endl;
+    for (auto &input : plan.inputs)
+        printPlan(input, depth + 1);
+}
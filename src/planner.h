@@ -0,0 +1,83 @@
+#include"operators.h"
+
+/**
+ * @brief Physical implementations the planner chooses between.
+ *
+ */
+enum PhysicalOperator
+{
+    TABLE_SCAN,
+    INDEX_SCAN,
+    FILTER,
+    PROJECT,
+    BLOCK_NESTED_LOOP_JOIN,
+    HASH_JOIN,
+    INDEX_NESTED_LOOP_JOIN,
+    SORT_MERGE_JOIN,
+    IN_MEMORY_SORT,
+    TOP_K_SORT,
+    EXTERNAL_SORT,
+    HASH_DISTINCT,
+    PARTITIONED_HASH_DISTINCT,
+    SORT_DISTINCT,
+    HASH_GROUP_BY,
+    PARTITIONED_HASH_GROUP_BY,
+    SORT_GROUP_BY
+};
+
+/**
+ * @brief A node of a physical plan: the implementation chosen for one
+ * operator, the plans of its inputs and its estimated cost in block I/Os.
+ * The cost is that of the node alone. Reading a table once is accounted to
+ * the scan (or index search) reading it, so a node only counts the reads and
+ * writes it makes on top of consuming its inputs once: temporary tables,
+ * partitions, sorted runs and repeated passes over an input.
+ *
+ */
+struct PhysicalPlan
+{
+    PhysicalOperator physicalOperator = TABLE_SCAN;
+    string detail = "";
+    long long estimatedRowCount = 0;
+    double blockReads = 0;
+    double blockWrites = 0;
+    //For joins, whether the first input is the outer relation of a nested
+    //loop join or the relation a hash join builds its table from
+    bool firstIsOuter = true;
+    vector<PhysicalPlan> inputs;
+
+    double getTotalBlockReads() const;
+    double getTotalBlockWrites() const;
+};
+
+/**
+ * @brief Estimates of one input of a join: the plan producing it, the base
+ * table it is (NULL for intermediate results) and the statistics of its join
+ * column. columnIndex is -1 for cross products.
+ *
+ */
+struct JoinInput
+{
+    PhysicalPlan plan;
+    Table *table = NULL;
+    string relationName = "";
+    string columnName = "";
+    int columnIndex = -1;
+    uint distinctValueCount = 0;
+    long long rowCount = 0;
+    double blockCount = 0;
+};
+
+JoinInput getJoinInput(Table *table, int columnIndex);
+long long estimateJoinRowCount(long long firstRowCount, uint firstDistinctValueCount, long long secondRowCount, uint secondDistinctValueCount, BinaryOperator binaryOperator);
+string describeJoin(const JoinInput &first, const JoinInput &second, BinaryOperator binaryOperator);
+string describeConditions(const vector<vector<BoundCondition>> &conjunctions, const vector<string> &columns);
+PhysicalPlan planScan(Table *table);
+PhysicalPlan planSelection(Table *table, const vector<vector<BoundCondition>> &conjunctions);
+PhysicalPlan planJoin(const JoinInput &first, const JoinInput &second, BinaryOperator binaryOperator);
+PhysicalPlan planSort(const PhysicalPlan &input, double blockCount, int limit, bool isTemporary);
+PhysicalPlan planSort(Table *table, int limit);
+PhysicalPlan planDistinct(Table *table);
+PhysicalPlan planGroupBy(Table *table, int columnIndex, int resultantColumnCount);
+string describePlan(const PhysicalPlan &plan);
+void printPlan(const PhysicalPlan &plan, int depth = 0);
@@ -0,0 +1,192 @@
+#include "global.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PREDICATE_SIMD
+#endif
+
+/**
+ * @brief Scalar loop, used on processors without the vector extensions and
+ * for the values left over after the last full vector. Every position is
+ * written to selection and kept only if the comparison holds, so the loop has
+ * no branches.
+ *
+ * @param from first position to evaluate
+ * @param selectedCount number of positions already in selection
+ * @return int number of positions in selection
+ */
+template <BinaryOperator binaryOperator, bool isLiteral>
+static int filterScalar(const int *values1, const int *values2, int literal, int from, int valueCount, int *selection, int selectedCount)
+{
+    for (int position = from; position < valueCount; position++)
+    {
+        selection[selectedCount] = position;
+        selectedCount += compare<binaryOperator>(values1[position], isLiteral ? literal : values2[position]);
+    }
+    return selectedCount;
+}
+
+template <BinaryOperator binaryOperator, bool isLiteral>
+static int scalarKernel(const int *values1, const int *values2, int literal, int valueCount, int *selection)
+{
+    return filterScalar<binaryOperator, isLiteral>(values1, values2, literal, 0, valueCount, selection, 0);
+}
+
+static int emptyKernel(const int *values1, const int *values2, int literal, int valueCount, int *selection)
+{
+    return 0;
+}
+
+#ifdef PREDICATE_SIMD
+/**
+ * @brief Appends the positions of the set bits of mask, relative to base, to
+ * the selection vector.
+ */
+static inline int appendSelected(unsigned mask, int base, int *selection, int selectedCount)
+{
+    while (mask)
+    {
+        selection[selectedCount++] = base + __builtin_ctz(mask);
+        mask &= mask - 1;
+    }
+    return selectedCount;
+}
+
+/**
+ * @brief Only > and == exist as vector comparisons, the other operators are
+ * obtained by swapping the operands and or negating the result.
+ */
+constexpr bool isEquality(BinaryOperator binaryOperator)
+{
+    return binaryOperator == EQUAL || binaryOperator == NOT_EQUAL;
+}
+
+constexpr bool swapsOperands(BinaryOperator binaryOperator)
+{
+    return binaryOperator == LESS_THAN || binaryOperator == GEQ;
+}
+
+constexpr bool negatesResult(BinaryOperator binaryOperator)
+{
+    return binaryOperator == LEQ || binaryOperator == GEQ || binaryOperator == NOT_EQUAL;
+}
+
+template <BinaryOperator binaryOperator, bool isLiteral>
+__attribute__((target("avx2"))) static int avx2Kernel(const int *values1, const int *values2, int literal, int valueCount, int *selection)
+{
+    const unsigned negation = negatesResult(binaryOperator) ? 0xFF : 0;
+    __m256i literalVector = _mm256_set1_epi32(literal);
+    int selectedCount = 0, position = 0;
+    for (; position + 8 <= valueCount; position += 8)
+    {
+        __m256i first = _mm256_loadu_si256((const __m256i *)(values1 + position));
+        __m256i second = isLiteral ? literalVector : _mm256_loadu_si256((const __m256i *)(values2 + position));
+        __m256i result;
+        if (isEquality(binaryOperator))
+            result = _mm256_cmpeq_epi32(first, second);
+        else if (swapsOperands(binaryOperator))
+            result = _mm256_cmpgt_epi32(second, first);
+        else
+            result = _mm256_cmpgt_epi32(first, second);
+        unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(result)) ^ negation;
+        selectedCount = appendSelected(mask, position, selection, selectedCount);
+    }
+    return filterScalar<binaryOperator, isLiteral>(values1, values2, literal, position, valueCount, selection, selectedCount);
+}
+
+template <BinaryOperator binaryOperator, bool isLiteral>
+__attribute__((target("sse4.2"))) static int sseKernel(const int *values1, const int *values2, int literal, int valueCount, int *selection)
+{
+    const unsigned negation = negatesResult(binaryOperator) ? 0xF : 0;
+    __m128i literalVector = _mm_set1_epi32(literal);
+    int selectedCount = 0, position = 0;
+    for (; position + 4 <= valueCount; position += 4)
+    {
+        __m128i first = _mm_loadu_si128((const __m128i *)(values1 + position));
+        __m128i second = isLiteral ? literalVector : _mm_loadu_si128((const __m128i *)(values2 + position));
+        __m128i result;
+        if (isEquality(binaryOperator))
+            result = _mm_cmpeq_epi32(first, second);
+        else if (swapsOperands(binaryOperator))
+            result = _mm_cmpgt_epi32(second, first);
+        else
+            result = _mm_cmpgt_epi32(first, second);
+        unsigned mask = _mm_movemask_ps(_mm_castsi128_ps(result)) ^ negation;
+        selectedCount = appendSelected(mask, position, selection, selectedCount);
+    }
+    return filterScalar<binaryOperator, isLiteral>(values1, values2, literal, position, valueCount, selection, selectedCount);
+}
+#endif
+
+/**
+ * @brief Picks the widest instantiation of the kernel the processor supports.
+ */
+template <BinaryOperator binaryOperator, bool isLiteral>
+static PredicateKernel selectKernel()
+{
+#ifdef PREDICATE_SIMD
+    if (__builtin_cpu_supports("avx2"))
+        return avx2Kernel<binaryOperator, isLiteral>;
+    if (__builtin_cpu_supports("sse4.2"))
+        return sseKernel<binaryOperator, isLiteral>;
+#endif
+    return scalarKernel<binaryOperator, isLiteral>;
+}
+
+template <bool isLiteral>
+static PredicateKernel selectKernel(BinaryOperator binaryOperator)
+{
+    switch (binaryOperator)
+    {
+    case LESS_THAN:
+        return selectKernel<LESS_THAN, isLiteral>();
+    case GREATER_THAN:
+        return selectKernel<GREATER_THAN, isLiteral>();
+    case LEQ:
+        return selectKernel<LEQ, isLiteral>();
+    case GEQ:
+        return selectKernel<GEQ, isLiteral>();
+    case EQUAL:
+        return selectKernel<EQUAL, isLiteral>();
+    case NOT_EQUAL:
+        return selectKernel<NOT_EQUAL, isLiteral>();
+    default:
+        return emptyKernel;
+    }
+}
+
+/**
+ * @brief Returns the kernel evaluating binaryOperator against a literal if
+ * isLiteral is set, against a second column otherwise.
+ *
+ * @param binaryOperator 
+ * @param isLiteral 
+ * @return PredicateKernel 
+ */
+PredicateKernel getPredicateKernel(BinaryOperator binaryOperator, bool isLiteral)
+{
+    return isLiteral ? selectKernel<true>(binaryOperator) : selectKernel<false>(binaryOperator);
+}
+
+/**
+ * @brief Returns the operator that gives the same result with the operands
+ * swapped, i.e. value1 op value2 == value2 mirror(op) value1.
+ *
+ * @param binaryOperator 
+ * @return BinaryOperator 
+ */
+BinaryOperator mirrorBinaryOperator(BinaryOperator binaryOperator)
+{
+    switch (binaryOperator)
+    {
+    case LESS_THAN:
+        return GREATER_THAN;
+    case GREATER_THAN:
+        return LESS_THAN;
+    case LEQ:
+        return GEQ;
+    case GEQ:
+        return LEQ;
+    default:
+        return binaryOperator;
+    }
+}
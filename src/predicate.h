@@ -0,0 +1,47 @@
+#include"semanticParser.h"
+
+/**
+ * @brief Compares value1 with value2 using an operator fixed at compile time,
+ * so that the comparison inlines to a single instruction.
+ *
+ */
+template <BinaryOperator binaryOperator>
+inline bool compare(int value1, int value2)
+{
+    switch (binaryOperator)
+    {
+    case LESS_THAN:
+        return value1 < value2;
+    case GREATER_THAN:
+        return value1 > value2;
+    case LEQ:
+        return value1 <= value2;
+    case GEQ:
+        return value1 >= value2;
+    case EQUAL:
+        return value1 == value2;
+    case NOT_EQUAL:
+        return value1 != value2;
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief Predicate kernels compare a column chunk, held contiguously, against
+ * an integer literal or against a second column chunk and write the positions
+ * of the values that satisfy the comparison into a selection vector, in
+ * increasing order. There is one kernel per operator and operand kind, each
+ * instantiated from a template, and each uses AVX2 or SSE instructions when
+ * the processor supports them with a scalar loop as fallback. A query picks
+ * its kernel once with getPredicateKernel and calls it on every chunk.
+ *
+ * values2 is ignored by literal kernels and literal by column kernels;
+ * selection must have room for valueCount positions. The kernel returns the
+ * number of selected positions.
+ *
+ */
+typedef int (*PredicateKernel)(const int *values1, const int *values2, int literal, int valueCount, int *selection);
+
+PredicateKernel getPredicateKernel(BinaryOperator binaryOperator, bool isLiteral);
+BinaryOperator mirrorBinaryOperator(BinaryOperator binaryOperator);
@@ -6,8 +6,10 @@ bool semanticParse(){
         case CLEAR: return semanticParseCLEAR();
         case CROSS: return semanticParseCROSS();
         case DISTINCT: return semanticParseDISTINCT();
+        case EXPLAIN: return semanticParseEXPLAIN();
         case EXPORT: return semanticParseEXPORT();
         case EXPORTMATRIX: return semanticParseEXPORTMATRIX();
+        case GROUPBY: return semanticParseGROUPBY();
         case INDEX: return semanticParseINDEX();
         case JOIN: return semanticParseJOIN();
         case LIST: return semanticParseLIST();
@@ -16,6 +18,7 @@ bool semanticParse(){
         case TRANSPOSE: return semanticParseTRANSPOSE();
         case PRINT: return semanticParsePRINT();
         case PRINTMATRIX: return semanticParsePRINTMATRIX();
+        case PIPELINE: return semanticParsePIPELINE();
         case PROJECTION: return semanticParsePROJECTION();
         case RENAME: return semanticParseRENAME();
         case SELECTION: return semanticParseSELECTION();
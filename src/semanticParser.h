@@ -5,8 +5,10 @@ bool semanticParse();
 bool semanticParseCLEAR();
 bool semanticParseCROSS();
 bool semanticParseDISTINCT();
+bool semanticParseEXPLAIN();
 bool semanticParseEXPORT();
 bool semanticParseEXPORTMATRIX();
+bool semanticParseGROUPBY();
 bool semanticParseINDEX();
 bool semanticParseJOIN();
 bool semanticParseLIST();
@@ -15,6 +17,7 @@ bool semanticParseLOADMATRIX();
 bool semanticParseTRANSPOSE();
 bool semanticParsePRINT();
 bool semanticParsePRINTMATRIX();
+bool semanticParsePIPELINE();
 bool semanticParsePROJECTION();
 bool semanticParseRENAME();
 bool semanticParseSELECTION();
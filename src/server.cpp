@@ -6,6 +6,14 @@ using namespace std;
 
 float BLOCK_SIZE = 8;
 uint BLOCK_COUNT = 2;
+// Number of blocks an operator may hold in main memory at once (sort runs,
+// hash tables, join chunks) before it has to spill to disk
+uint MEMORY_BLOCK_COUNT = 10;
+// Number of threads parallel work runs on, the thread pool's workers and the
+// thread waiting on them
+uint WORKER_COUNT = max(thread::hardware_concurrency(), 1u);
+// Whether to bind every worker thread of the pool to a core of its own
+bool PIN_WORKER_THREADS = false;
 uint PRINT_COUNT = 20;
 Logger logger;
 vector<string> tokenizedQuery;
@@ -13,6 +21,7 @@ ParsedQuery parsedQuery;
 TableCatalogue tableCatalogue;
 MatrixCatalogue matrixCatalogue;
 BufferManager bufferManager;
+ThreadPool threadPool(WORKER_COUNT - 1, PIN_WORKER_THREADS);
 
 void doCommand()
 {
@@ -32,7 +41,6 @@ void doCommand()
 int main(void)
 {
 
-    regex delim("[^\\s,]+");
     string command;
     system("rm -rf ../data/temp");
     system("mkdir ../data/temp");
@@ -45,11 +53,7 @@ int main(void)
         logger.log("\nReading New Command: ");
         getline(cin, command);
         logger.log(command);
-
-        auto words_begin = std::sregex_iterator(command.begin(), command.end(), delim);
-        auto words_end = std::sregex_iterator();
-        for (std::sregex_iterator i = words_begin; i != words_end; ++i)
-            tokenizedQuery.emplace_back((*i).str());
+        tokenizedQuery = tokenizeCommand(command);
 
         if (tokenizedQuery.size() == 1 && tokenizedQuery.front() == "QUIT")
         {
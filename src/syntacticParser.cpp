@@ -13,6 +13,8 @@ bool syntacticParse()
 
     if (possibleQueryType == "CLEAR")
         return syntacticParseCLEAR();
+    else if (possibleQueryType == "EXPLAIN")
+        return syntacticParseEXPLAIN();
     else if (possibleQueryType == "INDEX")
         return syntacticParseINDEX();
     else if (possibleQueryType == "LIST")
@@ -50,7 +52,12 @@ bool syntacticParse()
             return false;
         }
         possibleQueryType = tokenizedQuery[2];
-        if (possibleQueryType == "PROJECT")
+        //Aggregates are written with parentheses, GROUP BY is never nested
+        if (possibleQueryType == "GROUP")
+            return syntacticParseGROUPBY();
+        else if (find(tokenizedQuery.begin(), tokenizedQuery.end(), "(") != tokenizedQuery.end())
+            return syntacticParsePIPELINE();
+        else if (possibleQueryType == "PROJECT")
             return syntacticParsePROJECTION();
         else if (possibleQueryType == "SELECT")
             return syntacticParseSELECTION();
@@ -89,8 +96,16 @@ void ParsedQuery::clear()
     this->distinctResultRelationName = "";
     this->distinctRelationName = "";
 
+    this->explainQueryType = UNDETERMINED;
+    this->explainAnalyze = false;
+
     this->exportRelationName = "";
 
+    this->groupByResultRelationName = "";
+    this->groupByColumnName = "";
+    this->groupByRelationName = "";
+    this->groupByAggregates.clear();
+
     this->indexingStrategy = NOTHING;
     this->indexColumnName = "";
     this->indexRelationName = "";
@@ -106,6 +121,9 @@ void ParsedQuery::clear()
 
     this->printRelationName = "";
 
+    this->pipelineResultRelationName = "";
+    this->pipelinePlan.reset();
+
     this->projectionResultRelationName = "";
     this->projectionColumnList.clear();
     this->projectionRelationName = "";
@@ -114,18 +132,15 @@ void ParsedQuery::clear()
     this->renameToColumnName = "";
     this->renameRelationName = "";
 
-    this->selectType = NO_SELECT_CLAUSE;
-    this->selectionBinaryOperator = NO_BINOP_CLAUSE;
     this->selectionResultRelationName = "";
     this->selectionRelationName = "";
-    this->selectionFirstColumnName = "";
-    this->selectionSecondColumnName = "";
-    this->selectionIntLiteral = 0;
+    this->selectionConditions.clear();
 
     this->sortingStrategy = NO_SORT_CLAUSE;
     this->sortResultRelationName = "";
     this->sortColumnName = "";
     this->sortRelationName = "";
+    this->sortLimit = -1;
 
     this->sourceFileName = "";
 }
@@ -158,3 +173,21 @@ bool isQueryFile(string fileName){
     struct stat buffer;
     return (stat(fileName.c_str(), &buffer) == 0);
 }
+
+/**
+ * @brief Splits a command into tokens. Whitespace and commas separate tokens,
+ * parentheses are tokens of their own.
+ *
+ * @param command
+ * @return vector<string>
+ */
+vector<string> tokenizeCommand(string command)
+{
+    static regex delim("[()]|[^\\s,()]+");
+    vector<string> tokens;
+    auto words_begin = std::sregex_iterator(command.begin(), command.end(), delim);
+    auto words_end = std::sregex_iterator();
+    for (std::sregex_iterator i = words_begin; i != words_end; ++i)
+        tokens.emplace_back((*i).str());
+    return tokens;
+}
@@ -8,8 +8,10 @@ enum QueryType
     CLEAR,
     CROSS,
     DISTINCT,
+    EXPLAIN,
     EXPORT,
     EXPORTMATRIX,
+    GROUPBY,
     INDEX,
     JOIN,
     LIST,
@@ -18,6 +20,7 @@ enum QueryType
     TRANSPOSE,
     PRINT,
     PRINTMATRIX,
+    PIPELINE,
     PROJECTION,
     RENAME,
     SELECTION,
@@ -44,6 +47,15 @@ enum SortingStrategy
     NO_SORT_CLAUSE
 };
 
+enum AggregateFunction
+{
+    AVG,
+    COUNT,
+    MAX,
+    MIN,
+    SUM
+};
+
 enum SelectType
 {
     COLUMN,
@@ -51,6 +63,32 @@ enum SelectType
     NO_SELECT_CLAUSE
 };
 
+/**
+ * @brief One comparison of a SELECT condition, column_name bin_op
+ * [column_name | int_literal].
+ *
+ */
+struct SelectionCondition
+{
+    SelectType selectType = NO_SELECT_CLAUSE;
+    BinaryOperator binaryOperator = NO_BINOP_CLAUSE;
+    string firstColumnName = "";
+    string secondColumnName = "";
+    int intLiteral = 0;
+};
+
+/**
+ * @brief One aggregate of a GROUP BY statement, aggregate_function(column_name).
+ *
+ */
+struct Aggregate
+{
+    AggregateFunction aggregateFunction = COUNT;
+    string columnName = "";
+};
+
+struct PlanNode;
+
 class ParsedQuery
 {
 
@@ -66,8 +104,16 @@ public:
     string distinctResultRelationName = "";
     string distinctRelationName = "";
 
+    QueryType explainQueryType = UNDETERMINED;
+    bool explainAnalyze = false;
+
     string exportRelationName = "";
 
+    string groupByResultRelationName = "";
+    string groupByColumnName = "";
+    string groupByRelationName = "";
+    vector<Aggregate> groupByAggregates;
+
     IndexingStrategy indexingStrategy = NOTHING;
     string indexColumnName = "";
     string indexRelationName = "";
@@ -83,6 +129,9 @@ public:
 
     string printRelationName = "";
 
+    string pipelineResultRelationName = "";
+    shared_ptr<PlanNode> pipelinePlan;
+
     string projectionResultRelationName = "";
     vector<string> projectionColumnList;
     string projectionRelationName = "";
@@ -91,18 +140,16 @@ public:
     string renameToColumnName = "";
     string renameRelationName = "";
 
-    SelectType selectType = NO_SELECT_CLAUSE;
-    BinaryOperator selectionBinaryOperator = NO_BINOP_CLAUSE;
     string selectionResultRelationName = "";
     string selectionRelationName = "";
-    string selectionFirstColumnName = "";
-    string selectionSecondColumnName = "";
-    int selectionIntLiteral = 0;
+    //OR of AND-groups of comparisons, AND binds tighter than OR
+    vector<vector<SelectionCondition>> selectionConditions;
 
     SortingStrategy sortingStrategy = NO_SORT_CLAUSE;
     string sortResultRelationName = "";
     string sortColumnName = "";
     string sortRelationName = "";
+    int sortLimit = -1;
 
     string sourceFileName = "";
 
@@ -110,12 +157,27 @@ public:
     void clear();
 };
 
+/**
+ * @brief Node of the plan of a statement with nested statements. A leaf names
+ * a relation; any other node holds a statement parsed by its usual parser in
+ * which the nested statements, its children, are named #0, #1, ...
+ *
+ */
+struct PlanNode
+{
+    string relationName = "";
+    ParsedQuery query;
+    vector<shared_ptr<PlanNode>> children;
+};
+
 bool syntacticParse();
 bool syntacticParseCLEAR();
 bool syntacticParseCROSS();
 bool syntacticParseDISTINCT();
+bool syntacticParseEXPLAIN();
 bool syntacticParseEXPORT();
 bool syntacticParseEXPORTMATRIX();
+bool syntacticParseGROUPBY();
 bool syntacticParseINDEX();
 bool syntacticParseJOIN();
 bool syntacticParseLIST();
@@ -124,6 +186,7 @@ bool syntacticParseLOADMATRIX();
 bool syntacticParseTRANSPOSE();
 bool syntacticParsePRINT();
 bool syntacticParsePRINTMATRIX();
+bool syntacticParsePIPELINE();
 bool syntacticParsePROJECTION();
 bool syntacticParseRENAME();
 bool syntacticParseSELECTION();
@@ -132,3 +195,4 @@ bool syntacticParseSOURCE();
 
 bool isFileExists(string tableName);
 bool isQueryFile(string fileName);
+vector<string> tokenizeCommand(string command);
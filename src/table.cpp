@@ -94,9 +94,34 @@ bool Table::extractColumnNames(string firstLine)
     return true;
 }
 
+/**
+ * @brief Parses the lines of one page of the source file into rows.
+ *
+ * @return true if every line holds columnCount integers
+ * @return false otherwise
+ */
+static bool parsePage(const vector<string> &lines, int firstLine, int endLine, int columnCount, vector<vector<int>> &rowsInPage)
+{
+    string word;
+    rowsInPage.assign(endLine - firstLine, vector<int>(columnCount, 0));
+    for (int lineCounter = firstLine; lineCounter < endLine; lineCounter++)
+    {
+        stringstream s(lines[lineCounter]);
+        for (int columnCounter = 0; columnCounter < columnCount; columnCounter++)
+        {
+            if (!getline(s, word, ','))
+                return false;
+            rowsInPage[lineCounter - firstLine][columnCounter] = stoi(word);
+        }
+    }
+    return true;
+}
+
 /**
  * @brief This function splits all the rows and stores them in multiple files of
- * one block size.
+ * one block size. The file is read WORKER_COUNT pages worth of lines at a
+ * time. The pages are parsed and written by tasks of the thread pool, the
+ * statistics are then updated page by page.
  *
  * @return true if successfully blockified
  * @return false otherwise
@@ -105,42 +130,49 @@ bool Table::blockify()
 {
     logger.log("Table::blockify");
     ifstream fin(this->sourceFileName, ios::in);
-    string line, word;
-    vector<int> row(this->columnCount, 0);
-    vector<vector<int>> rowsInPage(this->maxRowsPerBlock, row);
-    int pageCounter = 0;
+    string line;
     unordered_set<int> dummy;
     dummy.clear();
     this->distinctValuesInColumns.assign(this->columnCount, dummy);
     this->distinctValuesPerColumnCount.assign(this->columnCount, 0);
     getline(fin, line);
-    while (getline(fin, line))
+
+    vector<string> lines;
+    vector<vector<vector<int>>> pages(WORKER_COUNT);
+    while (true)
     {
-        stringstream s(line);
-        for (int columnCounter = 0; columnCounter < this->columnCount; columnCounter++)
+        lines.clear();
+        while (lines.size() < (long long)WORKER_COUNT * this->maxRowsPerBlock && getline(fin, line))
+            lines.emplace_back(line);
+        if (lines.empty())
+            break;
+
+        int pageCount = (lines.size() + this->maxRowsPerBlock - 1) / this->maxRowsPerBlock;
+        atomic<bool> isValid(true);
+        TaskGroup parsing;
+        for (int pageCounter = 0; pageCounter < pageCount; pageCounter++)
         {
-            if (!getline(s, word, ','))
-                return false;
-            row[columnCounter] = stoi(word);
-            rowsInPage[pageCounter][columnCounter] = row[columnCounter];
+            parsing.submit([&, pageCounter]() {
+                int firstLine = pageCounter * this->maxRowsPerBlock;
+                int endLine = min(firstLine + (int)this->maxRowsPerBlock, (int)lines.size());
+                if (!parsePage(lines, firstLine, endLine, this->columnCount, pages[pageCounter]))
+                    isValid = false;
+                else
+                    bufferManager.writePage(this->tableName, this->blockCount + pageCounter, pages[pageCounter], endLine - firstLine);
+            });
         }
-        pageCounter++;
-        this->updateStatistics(row);
-        if (pageCounter == this->maxRowsPerBlock)
+        parsing.wait();
+        if (!isValid)
+            return false;
+
+        for (int pageCounter = 0; pageCounter < pageCount; pageCounter++)
         {
-            bufferManager.writePage(this->tableName, this->blockCount, rowsInPage, pageCounter);
+            for (auto &row : pages[pageCounter])
+                this->updateStatistics(row);
             this->blockCount++;
-            this->rowsPerBlockCount.emplace_back(pageCounter);
-            pageCounter = 0;
+            this->rowsPerBlockCount.emplace_back(pages[pageCounter].size());
         }
     }
-    if (pageCounter)
-    {
-        bufferManager.writePage(this->tableName, this->blockCount, rowsInPage, pageCounter);
-        this->blockCount++;
-        this->rowsPerBlockCount.emplace_back(pageCounter);
-        pageCounter = 0;
-    }
 
     if (this->rowCount == 0)
         return false;
@@ -208,6 +240,10 @@ void Table::renameColumn(string fromColumnName, string toColumnName)
             break;
         }
     }
+    if (this->indexedColumn == fromColumnName)
+        this->indexedColumn = toColumnName;
+    if (this->sortedColumn == fromColumnName)
+        this->sortedColumn = toColumnName;
     return;
 }
 
@@ -252,6 +288,29 @@ void Table::getNextPage(Cursor *cursor)
     }
 }
 
+/**
+ * @brief Writes the rows of page pageIndex of table as csv lines.
+ */
+static string formatPage(Table *table, int pageIndex)
+{
+    ostringstream text;
+    Cursor cursor(table->tableName, pageIndex, pageIndex + 1);
+    for (RowBatch batch = cursor.getNextBatch(); !batch.empty(); batch = cursor.getNextBatch())
+    {
+        for (auto &row : batch)
+        {
+            for (int columnCounter = 0; columnCounter < row.size(); columnCounter++)
+            {
+                if (columnCounter != 0)
+                    text << ", ";
+                text << row[columnCounter];
+            }
+            text << "\n";
+        }
+    }
+    return text.str();
+}
+
 /**
  * @brief called when EXPORT command is invoked to move source file to "data"
  * folder.
@@ -268,12 +327,18 @@ void Table::makePermanent()
     //print headings
     this->writeRow(this->columns, fout);
 
-    Cursor cursor(this->tableName, 0);
-    vector<int> row;
-    for (int rowCounter = 0; rowCounter < this->rowCount; rowCounter++)
+    //Pages are formatted by tasks of the thread pool, WORKER_COUNT at a time,
+    //and written out in order
+    vector<string> pageTexts(WORKER_COUNT);
+    for (int firstPageIndex = 0; firstPageIndex < this->blockCount; firstPageIndex += WORKER_COUNT)
     {
-        row = cursor.getNext();
-        this->writeRow(row, fout);
+        int pageCount = min((int)WORKER_COUNT, (int)this->blockCount - firstPageIndex);
+        TaskGroup formatting;
+        for (int pageCounter = 0; pageCounter < pageCount; pageCounter++)
+            formatting.submit([&, pageCounter]() { pageTexts[pageCounter] = formatPage(this, firstPageIndex + pageCounter); });
+        formatting.wait();
+        for (int pageCounter = 0; pageCounter < pageCount; pageCounter++)
+            fout << pageTexts[pageCounter];
     }
     fout.close();
 }
@@ -300,6 +365,12 @@ bool Table::isPermanent()
 void Table::unload()
 {
     logger.log("Table::~unload");
+    if (this->index)
+    {
+        this->index->unload();
+        delete this->index;
+        this->index = NULL;
+    }
     for (int pageCounter = 0; pageCounter < this->blockCount; pageCounter++)
         bufferManager.deleteFile(this->tableName, pageCounter);
     if (!isPermanent())
@@ -317,6 +388,30 @@ Cursor Table::getCursor()
     Cursor cursor(this->tableName, 0);
     return cursor;
 }
+/**
+ * @brief Reads the rows at the given (pageIndex, pagePointer) locations, e.g.
+ * the result of an index search. Locations are visited in page order so every
+ * page is read at most once; the rows are returned in that order.
+ *
+ * @param rowLocations
+ * @return vector<vector<int>>
+ */
+vector<vector<int>> Table::getRows(vector<pair<int, int>> rowLocations)
+{
+    logger.log("Table::getRows");
+    vector<vector<int>> rows;
+    rows.reserve(rowLocations.size());
+    sort(rowLocations.begin(), rowLocations.end());
+    TablePage page;
+    for (auto &rowLocation : rowLocations)
+    {
+        if (page.pageIndex != rowLocation.first)
+            page = bufferManager.getPage(this->tableName, rowLocation.first);
+        rows.emplace_back(page.getRow(rowLocation.second));
+    }
+    return rows;
+}
+
 /**
  * @brief Function that returns the index of column indicated by columnName
  *
@@ -1,9 +1,10 @@
-#include "cursor.h"
+#include "tableIndex.h"
 
 enum IndexingStrategy
 {
     BTREE,
     HASH,
+    BITMAP,
     NOTHING
 };
 
@@ -33,6 +34,10 @@ public:
     bool indexed = false;
     string indexedColumn = "";
     IndexingStrategy indexingStrategy = NOTHING;
+    TableIndex *index = NULL;
+    //Column the rows are stored in order of (ascending or descending), empty
+    //if unknown
+    string sortedColumn = "";
     
     bool extractColumnNames(string firstLine);
     bool blockify();
@@ -48,6 +53,7 @@ public:
     bool isPermanent();
     void getNextPage(Cursor *cursor);
     Cursor getCursor();
+    vector<vector<int>> getRows(vector<pair<int, int>> rowLocations);
     int getColumnIndex(string columnName);
     void unload();
 
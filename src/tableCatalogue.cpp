@@ -38,6 +38,23 @@ bool TableCatalogue::isColumnFromTable(string columnName, string tableName)
     return false;
 }
 
+/**
+ * @brief Returns a table name starting with prefix that is not in use. Executors
+ * that spill intermediate results to disk (sort runs, partitions) store them as
+ * temporary tables under such names.
+ *
+ * @param prefix
+ * @return string
+ */
+string TableCatalogue::getTempTableName(string prefix)
+{
+    logger.log("TableCatalogue::getTempTableName");
+    int counter = 0;
+    while (this->isTable(prefix + to_string(counter)))
+        counter++;
+    return prefix + to_string(counter);
+}
+
 void TableCatalogue::print()
 {
     logger.log("TableCatalogue::print"); 
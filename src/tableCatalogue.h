@@ -1,4 +1,4 @@
-#include "table.h"
+#include "bitmapIndex.h"
 
 /**
  * @brief The TableCatalogue acts like an index of tables existing in the
@@ -18,6 +18,7 @@ public:
     Table* getTable(string tableName);
     bool isTable(string tableName);
     bool isColumnFromTable(string columnName, string tableName);
+    string getTempTableName(string prefix);
     void print();
     ~TableCatalogue();
 };
\ No newline at end of file
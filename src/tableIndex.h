@@ -0,0 +1,34 @@
+#include "cursor.h"
+
+/**
+ * @brief The TableIndex is the interface shared by all secondary indices that
+ * can be built on a column of a table using the INDEX command. An index maps
+ * values of the indexed column to the locations of the rows holding them, a
+ * location being the pair (pageIndex, pagePointer) a cursor would use to reach
+ * the row.
+ *
+ */
+class TableIndex
+{
+public:
+    virtual ~TableIndex() {}
+
+    /**
+     * @brief Returns the locations of all rows whose value in the indexed column
+     * lies in [lowValue, highValue]. Indices that do not support range searches
+     * are only ever called with lowValue == highValue.
+     */
+    virtual vector<pair<int, int>> search(int lowValue, int highValue) = 0;
+    virtual bool supportsRangeSearch() = 0;
+
+    /**
+     * @brief Estimated number of index pages read by a single search, not
+     * counting the pages of the table the matching rows are fetched from.
+     */
+    virtual int getSearchCost() = 0;
+
+    /**
+     * @brief Deletes the files holding the index.
+     */
+    virtual void unload() = 0;
+};
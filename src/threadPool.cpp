@@ -0,0 +1,145 @@
+#include "global.h"
+#include <sched.h>
+
+//Index of the worker the current thread is, -1 outside the pool
+static thread_local int currentWorkerIndex = -1;
+
+/**
+ * @brief Starts workerCount worker threads. With pinWorkers set worker i is
+ * bound to core i (modulo the number of cores), which on most machines keeps
+ * neighbouring workers on the same NUMA node.
+ *
+ * @param workerCount
+ * @param pinWorkers
+ */
+ThreadPool::ThreadPool(int workerCount, bool pinWorkers)
+{
+    logger.log("ThreadPool::ThreadPool");
+    this->queueCount = max(workerCount, 1);
+    this->queues.reset(new WorkerQueue[this->queueCount]);
+    for (int workerIndex = 0; workerIndex < workerCount; workerIndex++)
+        this->workers.emplace_back(&ThreadPool::workerLoop, this, workerIndex, pinWorkers);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        lock_guard<mutex> lock(this->sleepMutex);
+        this->stopping = true;
+    }
+    this->wakeUp.notify_all();
+    for (auto &worker : this->workers)
+        worker.join();
+}
+
+int ThreadPool::getWorkerCount()
+{
+    return this->workers.size();
+}
+
+void ThreadPool::workerLoop(int workerIndex, bool pinWorker)
+{
+    currentWorkerIndex = workerIndex;
+    if (pinWorker)
+    {
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET(workerIndex % max(thread::hardware_concurrency(), 1u), &cpuSet);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+    }
+    while (true)
+    {
+        if (this->runQueuedTask())
+            continue;
+        unique_lock<mutex> lock(this->sleepMutex);
+        this->wakeUp.wait(lock, [&] { return this->stopping || this->queuedTaskCount > 0; });
+        if (this->stopping && this->queuedTaskCount == 0)
+            return;
+    }
+}
+
+/**
+ * @brief Queues task on the deque of the submitting worker, or on the next
+ * worker's deque when submitted from outside the pool.
+ *
+ * @param task
+ */
+void ThreadPool::submit(function<void()> task)
+{
+    int queueIndex = currentWorkerIndex >= 0 ? currentWorkerIndex : this->nextQueue++ % this->queueCount;
+    {
+        lock_guard<mutex> lock(this->queues[queueIndex].queueMutex);
+        this->queues[queueIndex].tasks.emplace_back(move(task));
+    }
+    {
+        lock_guard<mutex> lock(this->sleepMutex);
+        this->queuedTaskCount++;
+    }
+    this->wakeUp.notify_one();
+}
+
+/**
+ * @brief Runs one queued task: the newest task of the calling worker's own
+ * deque if it has any, else the oldest task of another deque.
+ *
+ * @return true if a task was run
+ * @return false if every deque was empty
+ */
+bool ThreadPool::runQueuedTask()
+{
+    function<void()> task;
+    int ownQueue = currentWorkerIndex >= 0 ? currentWorkerIndex : 0;
+    for (int queueCounter = 0; queueCounter < this->queueCount && !task; queueCounter++)
+    {
+        int queueIndex = (ownQueue + queueCounter) % this->queueCount;
+        WorkerQueue &queue = this->queues[queueIndex];
+        lock_guard<mutex> lock(queue.queueMutex);
+        if (queue.tasks.empty())
+            continue;
+        if (queueIndex == currentWorkerIndex)
+        {
+            task = move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        else
+        {
+            task = move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+    }
+    if (!task)
+        return false;
+    this->queuedTaskCount--;
+    task();
+    return true;
+}
+
+/**
+ * @brief Submits task to the thread pool as part of the group.
+ *
+ * @param task
+ */
+void TaskGroup::submit(function<void()> task)
+{
+    this->pendingTaskCount++;
+    threadPool.submit([this, task]() {
+        task();
+        this->pendingTaskCount--;
+    });
+}
+
+/**
+ * @brief Returns once every task of the group has run, running queued tasks
+ * (of this group or any other) in the meantime.
+ */
+void TaskGroup::wait()
+{
+    while (this->pendingTaskCount > 0)
+        if (!threadPool.runQueuedTask())
+            this_thread::yield();
+}
+
+TaskGroup::~TaskGroup()
+{
+    this->wait();
+}
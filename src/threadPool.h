@@ -0,0 +1,66 @@
+#include "logger.h"
+
+/**
+ * @brief Process-wide work-stealing scheduler that runs the parallel parts of
+ * every executor, so that features running at the same time share one set of
+ * threads instead of each starting their own.
+ *
+ * <p>
+ * Every worker thread owns a deque of tasks. Tasks submitted from a worker go
+ * to the back of its own deque and the worker runs its tasks newest first.
+ * Tasks submitted from any other thread are dealt to the workers round robin.
+ * A worker whose deque is empty steals the oldest task of another worker, and
+ * sleeps once there is nothing left to steal anywhere.
+ * </p>
+ *
+ * <p>
+ * Tasks are submitted as part of a TaskGroup. TaskGroup::wait runs queued
+ * tasks until every task of the group is done. A thread waiting on a group
+ * therefore never sits idle, and a task may itself wait on a group without
+ * starving the pool.
+ * </p>
+ *
+ */
+class ThreadPool
+{
+    struct WorkerQueue
+    {
+        mutex queueMutex;
+        deque<function<void()>> tasks;
+    };
+
+    vector<thread> workers;
+    unique_ptr<WorkerQueue[]> queues;
+    int queueCount;
+    atomic<int> nextQueue{0};
+    atomic<long long> queuedTaskCount{0};
+    mutex sleepMutex;
+    condition_variable wakeUp;
+    bool stopping = false;
+
+    void workerLoop(int workerIndex, bool pinWorker);
+
+public:
+    ThreadPool(int workerCount, bool pinWorkers = false);
+    ~ThreadPool();
+    int getWorkerCount();
+    void submit(function<void()> task);
+    bool runQueuedTask();
+};
+
+/**
+ * @brief A set of tasks submitted to the thread pool that can be waited on
+ * together.
+ *
+ */
+class TaskGroup
+{
+    atomic<int> pendingTaskCount{0};
+
+public:
+    void submit(function<void()> task);
+    void wait();
+    ~TaskGroup();
+};
+
+extern ThreadPool threadPool;